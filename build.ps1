@@ -1,11 +1,19 @@
-function Build($build_dir, $enable_mutex, $build_type) {
+Function Build {
+  # Mandatory, so that a call with too few arguments fails instead of
+  # configuring with an empty build type.
+  Param(
+    [Parameter(Mandatory)][string]$build_dir,
+    [Parameter(Mandatory)][string]$build_type,
+    [Parameter(Mandatory)][string]$sqlite_profile
+  )
+
   if (-Not (Test-Path -Path $build_dir)) {
       mkdir $build_dir
   }
 
   Push-Location $build_dir
   $cpuCores = Get-CimInstance Win32_Processor | Measure-Object -Property NumberOfCores -Sum | Select-Object -ExpandProperty Sum
-  cmake -DCMAKE_BUILD_TYPE=$build_type -DENABLE_MUTEX:BOOL=$enable_mutex ..
+  cmake -DCMAKE_BUILD_TYPE=$build_type -DSQLITE_BUILD_PROFILE=$sqlite_profile ..
   cmake --build . --config $build_type --parallel $cpuCores
 
   if (-Not ($LASTEXITCODE -eq "0")) {
@@ -18,12 +26,14 @@ function Build($build_dir, $enable_mutex, $build_type) {
 
 $scriptDirectory = $PSScriptRoot
 Push-Location $scriptDirectory
-$build_dir_multi_threaded = 'build_multi_threaded'
-$build_dir_mutex = 'build_mutex'
-Build $build_dir_multi_threaded $false "Debug"
-Build $build_dir_multi_threaded $false "Release"
-Build $build_dir_mutex $true "Debug"
-Build $build_dir_mutex $true "Release"
+Build 'build' "Debug" "default"
+Build 'build' "Release" "default"
+
+# One Release build per other SQLite profile; compare them to the default
+# one with --baseline.
+foreach ($sqlite_profile in @("throughput", "small", "debug-instrumented")) {
+  Build "build-$sqlite_profile" "Release" $sqlite_profile
+}
+
 Pop-Location
 exit 0
-
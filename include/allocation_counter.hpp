@@ -0,0 +1,7 @@
+#pragma once
+#include <cstdint>
+
+namespace sqlite {
+// Number of calls to the global operator new made so far by the process.
+std::uint64_t allocationCount();
+} // namespace sqlite
@@ -0,0 +1,328 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "database_connection.hpp"
+
+namespace sqlite {
+// Runs queries on a fixed set of worker threads. Every worker owns one
+// database connection that no other thread touches, so the connections may
+// be opened with SQLITE_OPEN_NOMUTEX.
+// Every worker has its own task deque. Tasks submitted from outside are
+// spread over the workers round-robin, tasks submitted by a worker go to
+// its own deque. A worker runs its newest task first and, once its deque is
+// empty, steals the oldest task of another worker, so workers stuck on
+// heavy queries don't hold up the rest. The destructor finishes all queued
+// tasks.
+class AsyncExecutor {
+public:
+#ifdef __cpp_lib_move_only_function
+    using Task = std::move_only_function<void(DatabaseConnection&)>;
+#else
+    // Move-only stand-in for std::move_only_function. Unlike std::function
+    // it accepts callables that cannot be copied, such as ones owning a
+    // std::promise.
+    class Task {
+    public:
+        Task() noexcept
+            : m_callable{}
+        {
+        }
+
+        template <typename Function>
+            requires(!std::same_as<std::remove_cvref_t<Function>, Task>
+                     && std::invocable<
+                         std::decay_t<Function>&,
+                         DatabaseConnection&>)
+        Task(Function&& function)
+            : m_callable{std::make_unique<Callable<std::decay_t<Function>>>(
+                std::forward<Function>(function))}
+        {
+        }
+
+        Task(Task&& other) noexcept = default;
+
+        Task& operator=(Task&& other) noexcept = default;
+
+        void operator()(DatabaseConnection& connection)
+        {
+            m_callable->call(connection);
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return m_callable != nullptr;
+        }
+
+    private:
+        struct CallableBase {
+            virtual ~CallableBase() = default;
+
+            virtual void call(DatabaseConnection& connection) = 0;
+        };
+
+        template <typename Function>
+        struct Callable final : CallableBase {
+            template <typename Argument>
+            explicit Callable(Argument&& argument)
+                : function{std::forward<Argument>(argument)}
+            {
+            }
+
+            void call(DatabaseConnection& connection) override
+            {
+                function(connection);
+            }
+
+            Function function;
+        };
+
+        std::unique_ptr<CallableBase> m_callable;
+    };
+#endif
+
+    AsyncExecutor(
+        const char* filename,
+        int         flags,
+        const char* vfsModuleName,
+        std::size_t threadCount);
+
+    AsyncExecutor(const AsyncExecutor&) = delete;
+
+    AsyncExecutor& operator=(const AsyncExecutor&) = delete;
+
+    ~AsyncExecutor();
+
+    // Calls function(DatabaseConnection&) on a worker. Its result or
+    // exception is delivered through the future.
+    template <std::invocable<DatabaseConnection&> Function>
+    auto post(Function function)
+        -> std::future<std::invoke_result_t<Function&, DatabaseConnection&>>
+    {
+        using Result = std::invoke_result_t<Function&, DatabaseConnection&>;
+        std::promise<Result> promise{};
+        std::future<Result>  future{promise.get_future()};
+        enqueue([promise = std::move(promise), function = std::move(function)](
+                    DatabaseConnection& connection) mutable {
+            try {
+                if constexpr (std::is_void_v<Result>) {
+                    function(connection);
+                    promise.set_value();
+                }
+                else {
+                    promise.set_value(function(connection));
+                }
+            }
+            catch (...) {
+                promise.set_exception(std::current_exception());
+            }
+        });
+        return future;
+    }
+
+    // Like post(), but hands the result of function to continuation on the
+    // same worker, right after function returns, and delivers the result of
+    // continuation instead. An exception thrown by function skips
+    // continuation.
+    template <
+        std::invocable<DatabaseConnection&> Function,
+        typename Continuation>
+    auto post(Function function, Continuation continuation)
+    {
+        return post([function     = std::move(function),
+                     continuation = std::move(continuation)](
+                        DatabaseConnection& connection) mutable {
+            if constexpr (std::is_void_v<std::invoke_result_t<
+                              Function&,
+                              DatabaseConnection&>>) {
+                function(connection);
+                return continuation();
+            }
+            else {
+                return continuation(function(connection));
+            }
+        });
+    }
+
+    using Rows = std::vector<std::vector<PreparedStatement::Variant>>;
+
+    // Runs sqlStatement with values bound to its parameters through the
+    // worker's statement cache. The values are copied into the task, so
+    // views and borrowed values must outlive it.
+    template <typename... Values>
+    std::future<Rows> submit(std::string sqlStatement, Values... values)
+    {
+        return post(runQuery(std::move(sqlStatement), std::move(values)...));
+    }
+
+    // Like submit(), but calls continuation(Rows) on the worker with the
+    // rows and delivers its result through the future.
+    template <std::invocable<Rows> Continuation, typename... Values>
+    auto submit(
+        Continuation continuation,
+        std::string  sqlStatement,
+        Values... values)
+    {
+        return post(
+            runQuery(std::move(sqlStatement), std::move(values)...),
+            std::move(continuation));
+    }
+
+    // Awaitable returned by schedule(). Suspends the awaiting coroutine,
+    // calls function(DatabaseConnection&) on a worker and resumes the
+    // coroutine on that worker with the result, so no thread is blocked
+    // while the query waits in the queue. Code after the co_await runs on
+    // the worker until the next suspension and should hand off long work.
+    template <typename Function>
+    class Awaitable {
+    public:
+        using Result = std::invoke_result_t<Function&, DatabaseConnection&>;
+
+        Awaitable(AsyncExecutor& executor, Function function)
+            : m_executor{&executor}
+            , m_function{std::move(function)}
+            , m_result{}
+            , m_exception{}
+        {
+        }
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> coroutine)
+        {
+            m_executor->enqueue(
+                [this, coroutine](DatabaseConnection& connection) {
+                    try {
+                        if constexpr (std::is_void_v<Result>) {
+                            m_function(connection);
+                            m_result.emplace();
+                        }
+                        else {
+                            m_result.emplace(m_function(connection));
+                        }
+                    }
+                    catch (...) {
+                        m_exception = std::current_exception();
+                    }
+
+                    coroutine.resume();
+                });
+        }
+
+        Result await_resume()
+        {
+            if (m_exception) {
+                std::rethrow_exception(m_exception);
+            }
+
+            if constexpr (!std::is_void_v<Result>) {
+                return std::move(*m_result);
+            }
+        }
+
+    private:
+        using Storage = std::
+            conditional_t<std::is_void_v<Result>, std::monostate, Result>;
+
+        AsyncExecutor*         m_executor;
+        Function               m_function;
+        std::optional<Storage> m_result;
+        std::exception_ptr     m_exception;
+    };
+
+    // co_await executor.schedule([](DatabaseConnection& connection) { ... })
+    template <std::invocable<DatabaseConnection&> Function>
+    Awaitable<Function> schedule(Function function)
+    {
+        return Awaitable<Function>{*this, std::move(function)};
+    }
+
+    // co_await executor.query(sql, values...), the coroutine counterpart of
+    // submit().
+    template <typename... Values>
+    auto query(std::string sqlStatement, Values... values)
+    {
+        return schedule(
+            runQuery(std::move(sqlStatement), std::move(values)...));
+    }
+
+    // Runs task on a worker without reporting back; exceptions escaping
+    // task are printed to stderr.
+    void dispatch(Task task);
+
+    std::size_t threadCount() const;
+
+    // Number of tasks a worker took from another worker's deque.
+    std::uint64_t stealCount() const;
+
+    struct WorkerStatistics {
+        std::uint64_t            taskCount;
+        std::uint64_t            stolenTaskCount;
+        std::chrono::nanoseconds busyTime;
+    };
+
+    // Totals since construction, one entry per worker.
+    std::vector<WorkerStatistics> workerStatistics() const;
+
+private:
+    struct Worker {
+        Worker(const char* filename, int flags, const char* vfsModuleName);
+
+        std::mutex                 mutex;
+        std::deque<Task>           tasks;
+        DatabaseConnection         connection;
+        std::thread                thread;
+        std::atomic<std::uint64_t> taskCount;
+        std::atomic<std::uint64_t> stolenTaskCount;
+        std::atomic<std::int64_t>  busyNanoseconds;
+    };
+
+    template <typename... Values>
+    static auto runQuery(std::string sqlStatement, Values... values)
+    {
+        return [sqlStatement = std::move(sqlStatement),
+                values...](DatabaseConnection& connection) {
+            const StatementCache::Handle statement{
+                connection.cachedStatement(sqlStatement.c_str())};
+            statement->bindAll(values...);
+            return statement->run();
+        };
+    }
+
+    void enqueue(Task task);
+
+    bool takeTask(std::size_t workerIndex, Task& task);
+
+    void workerFunction(std::size_t workerIndex);
+
+    // m_mutex only guards sleeping and waking up, the deques have their own.
+    std::mutex                           m_mutex;
+    std::condition_variable              m_taskAvailable;
+    bool                                 m_stopping;
+    std::atomic<std::size_t>             m_queuedTaskCount;
+    std::atomic<std::size_t>             m_nextWorker;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+};
+} // namespace sqlite
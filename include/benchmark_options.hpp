@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+
+#include <string>
+
+namespace sqlite {
+// Relative weights of the query kinds in the mixed reader workload.
+struct QueryMix {
+    std::size_t scan;  // Reads the whole customer table.
+    std::size_t point; // Reads one customer by primary key.
+    std::size_t join;  // Joins the customer table with itself.
+};
+
+enum class ReportFormat { Text, Json, Csv };
+
+struct BenchmarkOptions {
+    std::size_t  threadCount{10};
+    std::size_t  iterationCount{500};
+    std::size_t  rowCount{500};
+    QueryMix     queryMix{49, 0, 1};
+    std::string  databasePath{"test_database.db"};
+    std::string  vfsName{};
+    ReportFormat reportFormat{ReportFormat::Text};
+    std::string  outputPath{"-"};
+    // Empty unless the thread-scaling sweep should run.
+    std::string  sweepOutputPath{};
+    // Empty unless the results should be compared to an earlier csv report.
+    std::string  baselinePath{};
+    bool         helpRequested{false};
+
+    // nullptr selects the default VFS.
+    const char* vfs() const;
+
+    // Whether the report or the sweep goes to stdout, in which case the
+    // progress output goes to stderr. At most one of them does.
+    bool reportsToStdout() const;
+
+    bool sweepsToStdout() const;
+};
+
+// Throws std::runtime_error for unknown options and invalid values.
+BenchmarkOptions parseBenchmarkOptions(int argc, const char* const* argv);
+
+const char* benchmarkUsage();
+
+const char* reportFormatName(ReportFormat format);
+
+// scan=49,point=0,join=1
+std::string toString(const QueryMix& queryMix);
+} // namespace sqlite
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark_options.hpp"
+
+namespace sqlite {
+// Collects the results of a benchmark run and writes them as JSON or CSV,
+// together with the options and the environment they were measured in.
+class BenchmarkReport {
+public:
+    struct WorkerTotals {
+        std::uint64_t taskCount;
+        std::uint64_t stolenTaskCount;
+        double        busyMilliseconds;
+    };
+
+    // In microseconds.
+    struct LatencyPercentiles {
+        double p50;
+        double p90;
+        double p99;
+        double p999;
+        double max;
+    };
+
+    struct Result {
+        std::string           name;
+        std::uint64_t         operationCount;
+        double                milliseconds;
+        std::optional<double> allocationsPerOperation;
+        // Empty unless the benchmark ran on an AsyncExecutor.
+        std::vector<WorkerTotals> workers;
+        // Only set by benchmarks that profile single statements.
+        std::optional<LatencyPercentiles> latency;
+
+        double operationsPerSecond() const;
+    };
+
+    explicit BenchmarkReport(BenchmarkOptions options);
+
+    // The sqlite_lib build profile this binary was built with, or "system"
+    // if it uses an SQLite that wasn't built by sqlite/CMakeLists.txt.
+    static const char* sqliteBuildProfile();
+
+    void add(Result result);
+
+    const std::vector<Result>& results() const;
+
+    void writeJson(std::ostream& os) const;
+
+    // One row per result and one per worker of a result, preceded by the
+    // options and the environment as comment lines starting with '#'.
+    void writeCsv(std::ostream& os) const;
+
+    // What an earlier run, typically one with the default SQLite build
+    // profile, measured.
+    struct Baseline {
+        std::string                             sqliteBuildProfile;
+        std::unordered_map<std::string, double> operationsPerSecond;
+    };
+
+    // Reads a report written by writeCsv(); throws std::runtime_error if it
+    // isn't one.
+    static Baseline readCsvBaseline(std::istream& is);
+
+private:
+    struct Environment {
+        std::string timestamp;
+        std::string sqliteVersion;
+        std::string sqliteSourceId;
+        std::string sqliteBuildProfile;
+        int         sqliteThreadsafe;
+        unsigned    hardwareConcurrency;
+        std::string compiler;
+        std::string operatingSystem;
+        bool        assertionsEnabled;
+    };
+
+    static Environment currentEnvironment();
+
+    BenchmarkOptions    m_options;
+    Environment         m_environment;
+    std::vector<Result> m_results;
+};
+} // namespace sqlite
@@ -0,0 +1,152 @@
+#pragma once
+#include <cstddef>
+
+#include <concepts>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include <sqlite3.h>
+
+#include "borrowed.hpp"
+
+namespace sqlite {
+inline int bindTextParameter(
+    sqlite3_stmt*           statement,
+    int                     placeholderIndex,
+    std::string_view        text,
+    sqlite3_destructor_type destructor)
+{
+    // A null pointer would bind NULL rather than an empty string.
+    return sqlite3_bind_text64(
+        statement,
+        placeholderIndex,
+        text.data() == nullptr ? "" : text.data(),
+        text.size(),
+        destructor,
+        SQLITE_UTF8);
+}
+
+inline int bindBlobParameter(
+    sqlite3_stmt*              statement,
+    int                        placeholderIndex,
+    std::span<const std::byte> bytes,
+    sqlite3_destructor_type    destructor)
+{
+    // A null pointer would bind NULL rather than an empty blob.
+    static const std::byte emptyBlob{};
+    return sqlite3_bind_blob64(
+        statement,
+        placeholderIndex,
+        bytes.data() == nullptr ? &emptyBlob : bytes.data(),
+        bytes.size(),
+        destructor);
+}
+
+// Binds a T to a parameter and returns the SQLite result code.
+// Specialize to support further types.
+template <typename T>
+struct BindTraits;
+
+template <std::integral T>
+struct BindTraits<T> {
+    static int bind(sqlite3_stmt* statement, int placeholderIndex, T value)
+    {
+        return sqlite3_bind_int64(
+            statement, placeholderIndex, static_cast<sqlite3_int64>(value));
+    }
+};
+
+template <std::floating_point T>
+struct BindTraits<T> {
+    static int bind(sqlite3_stmt* statement, int placeholderIndex, T value)
+    {
+        return sqlite3_bind_double(
+            statement, placeholderIndex, static_cast<double>(value));
+    }
+};
+
+template <>
+struct BindTraits<std::nullptr_t> {
+    static int bind(
+        sqlite3_stmt* statement,
+        int           placeholderIndex,
+        std::nullptr_t)
+    {
+        return sqlite3_bind_null(statement, placeholderIndex);
+    }
+};
+
+template <>
+struct BindTraits<std::string_view> {
+    static int bind(
+        sqlite3_stmt*    statement,
+        int              placeholderIndex,
+        std::string_view text)
+    {
+        return bindTextParameter(
+            statement, placeholderIndex, text, SQLITE_TRANSIENT);
+    }
+};
+
+template <>
+struct BindTraits<std::string> : BindTraits<std::string_view> {
+};
+
+template <>
+struct BindTraits<const char*> : BindTraits<std::string_view> {
+};
+
+template <>
+struct BindTraits<BorrowedText> {
+    static int bind(
+        sqlite3_stmt* statement,
+        int           placeholderIndex,
+        BorrowedText  text)
+    {
+        return bindTextParameter(
+            statement, placeholderIndex, text.text, SQLITE_STATIC);
+    }
+};
+
+template <>
+struct BindTraits<std::span<const std::byte>> {
+    static int bind(
+        sqlite3_stmt*              statement,
+        int                        placeholderIndex,
+        std::span<const std::byte> bytes)
+    {
+        return bindBlobParameter(
+            statement, placeholderIndex, bytes, SQLITE_TRANSIENT);
+    }
+};
+
+template <>
+struct BindTraits<BorrowedBlob> {
+    static int bind(
+        sqlite3_stmt* statement,
+        int           placeholderIndex,
+        BorrowedBlob  bytes)
+    {
+        return bindBlobParameter(
+            statement, placeholderIndex, bytes.bytes, SQLITE_STATIC);
+    }
+};
+
+// std::nullopt is bound as NULL.
+template <typename T>
+struct BindTraits<std::optional<T>> {
+    static int bind(
+        sqlite3_stmt*           statement,
+        int                     placeholderIndex,
+        const std::optional<T>& value)
+    {
+        if (!value.has_value()) {
+            return sqlite3_bind_null(statement, placeholderIndex);
+        }
+
+        return BindTraits<T>::bind(statement, placeholderIndex, *value);
+    }
+};
+} // namespace sqlite
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+
+#include <span>
+#include <string_view>
+
+namespace sqlite {
+// Text or a blob that SQLite references without copying it
+// (SQLITE_STATIC). The data must stay alive and unchanged until the
+// parameter is bound again, the bindings are cleared or the statement is
+// finalized.
+struct BorrowedText {
+    std::string_view text;
+};
+
+struct BorrowedBlob {
+    std::span<const std::byte> bytes;
+};
+
+inline BorrowedText borrow(std::string_view text)
+{
+    return BorrowedText{text};
+}
+
+inline BorrowedBlob borrow(std::span<const std::byte> bytes)
+{
+    return BorrowedBlob{bytes};
+}
+} // namespace sqlite
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+
+#include <optional>
+
+#include "database_connection.hpp"
+#include "throw.hpp"
+
+namespace sqlite {
+// Runs sqlStatement once for every element of rows, calling
+// bindRow(PreparedStatement&, row) to bind its values, and commits every
+// batchSize rows in an IMMEDIATE transaction. Only the current batch is
+// rolled back if a row fails. Returns the number of rows inserted.
+template <typename Range, typename BindRow>
+std::size_t bulkInsert(
+    DatabaseConnection& connection,
+    const char*         sqlStatement,
+    Range&&             rows,
+    std::size_t         batchSize,
+    BindRow             bindRow)
+{
+    if (batchSize == 0) {
+        SQLITE_THROW(
+            Exception,
+            SQLITE_MISUSE,
+            "bulkInsert: batchSize must not be 0. Statement: \"{}\"",
+            sqlStatement);
+    }
+
+    const StatementCache::Handle statement{
+        connection.cachedStatement(sqlStatement)};
+    std::optional<Transaction> transaction{};
+    std::size_t                rowCount{0};
+
+    for (auto&& row : rows) {
+        if (!transaction.has_value()) {
+            transaction.emplace(connection, Transaction::Mode::Immediate);
+        }
+
+        bindRow(*statement, row);
+        statement->run();
+        statement->reset();
+        ++rowCount;
+
+        if (rowCount % batchSize == 0) {
+            transaction->commit();
+            transaction.reset();
+        }
+    }
+
+    if (transaction.has_value()) {
+        transaction->commit();
+    }
+
+    return rowCount;
+}
+} // namespace sqlite
@@ -0,0 +1,153 @@
+#pragma once
+#include <cstddef>
+
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <sqlite3.h>
+
+namespace sqlite {
+// Reads a column as T, relying on SQLite's own type conversions instead of
+// inspecting sqlite3_column_type. Specialize to support further types.
+template <typename T>
+struct ColumnTraits;
+
+template <>
+struct ColumnTraits<sqlite3_int64> {
+    static sqlite3_int64 read(sqlite3_stmt* statement, int column)
+    {
+        return sqlite3_column_int64(statement, column);
+    }
+};
+
+template <>
+struct ColumnTraits<int> {
+    static int read(sqlite3_stmt* statement, int column)
+    {
+        return sqlite3_column_int(statement, column);
+    }
+};
+
+template <>
+struct ColumnTraits<double> {
+    static double read(sqlite3_stmt* statement, int column)
+    {
+        return sqlite3_column_double(statement, column);
+    }
+};
+
+// Only valid until the next step of the statement.
+template <>
+struct ColumnTraits<std::string_view> {
+    static std::string_view read(sqlite3_stmt* statement, int column)
+    {
+        const unsigned char* const text{
+            sqlite3_column_text(statement, column)};
+
+        if (text == nullptr) {
+            return std::string_view{};
+        }
+
+        return std::string_view{
+            reinterpret_cast<const char*>(text),
+            static_cast<std::size_t>(sqlite3_column_bytes(statement, column))};
+    }
+};
+
+// Only valid until the next step of the statement.
+template <>
+struct ColumnTraits<std::span<const std::byte>> {
+    static std::span<const std::byte> read(sqlite3_stmt* statement, int column)
+    {
+        // sqlite3_column_bytes has to be called after sqlite3_column_blob.
+        const void* const blob{sqlite3_column_blob(statement, column)};
+        const int         byteCount{sqlite3_column_bytes(statement, column)};
+        return std::span<const std::byte>{
+            static_cast<const std::byte*>(blob),
+            static_cast<std::size_t>(byteCount)};
+    }
+};
+
+template <>
+struct ColumnTraits<std::string> {
+    static std::string read(sqlite3_stmt* statement, int column)
+    {
+        return std::string{
+            ColumnTraits<std::string_view>::read(statement, column)};
+    }
+};
+
+// NULL is read as std::nullopt.
+template <typename T>
+struct ColumnTraits<std::optional<T>> {
+    static std::optional<T> read(sqlite3_stmt* statement, int column)
+    {
+        if (sqlite3_column_type(statement, column) == SQLITE_NULL) {
+            return std::nullopt;
+        }
+
+        return ColumnTraits<T>::read(statement, column);
+    }
+};
+
+template <typename T>
+struct IsColumnView : std::false_type {
+};
+
+template <>
+struct IsColumnView<std::string_view> : std::true_type {
+};
+
+template <>
+struct IsColumnView<std::span<const std::byte>> : std::true_type {
+};
+
+template <typename T>
+struct IsColumnView<std::optional<T>> : IsColumnView<T> {
+};
+
+// The column types of a row type: a std::tuple is its own column list,
+// other types list theirs in a nested Columns tuple, e.g.
+// struct Customer {
+//     using Columns = std::tuple<sqlite3_int64, std::string>;
+//     sqlite3_int64 id;
+//     std::string   name;
+// };
+template <typename T>
+struct RowColumns {
+    using type = typename T::Columns;
+};
+
+template <typename... Ts>
+struct RowColumns<std::tuple<Ts...>> {
+    using type = std::tuple<Ts...>;
+};
+
+template <typename T, typename Columns>
+struct RowReader;
+
+// Builds T from columns 0 to sizeof...(Columns) - 1 by aggregate
+// initialization.
+template <typename T, typename... Columns>
+struct RowReader<T, std::tuple<Columns...>> {
+    static constexpr bool containsViews{(IsColumnView<Columns>::value || ...)};
+
+    static T read(sqlite3_stmt* statement)
+    {
+        return read(statement, std::index_sequence_for<Columns...>{});
+    }
+
+private:
+    template <std::size_t... Indices>
+    static T read(sqlite3_stmt* statement, std::index_sequence<Indices...>)
+    {
+        return T{ColumnTraits<Columns>::read(
+            statement, static_cast<int>(Indices))...};
+    }
+};
+} // namespace sqlite
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sqlite3.h>
+
+#include "row.hpp"
+
+namespace sqlite {
+// A result set stored column by column. Every column keeps its values in
+// one contiguous array: int64 or double values, or offsets into a byte
+// buffer for text and blobs. NULLs are marked in a validity bitmap.
+// A column's type is taken from its first non-NULL value; later values are
+// converted to it by SQLite.
+class ColumnarResult {
+public:
+    enum class ColumnType { Null, Integer, Real, Text, Blob };
+
+    class Column {
+    public:
+        friend class ColumnarResult;
+
+        const std::string& name() const;
+
+        ColumnType type() const;
+
+        std::size_t size() const;
+
+        // Throws std::out_of_range if row >= size().
+        bool isValid(std::size_t row) const;
+
+        // Bit row % 64 of word row / 64 is set for non-NULL values.
+        std::span<const std::uint64_t> validityBitmap() const;
+
+        std::span<const sqlite3_int64> integers() const;
+
+        std::span<const double> reals() const;
+
+        // size() + 1 offsets into bytes(); row i spans
+        // [offsets()[i], offsets()[i + 1]).
+        std::span<const std::size_t> offsets() const;
+
+        std::span<const std::byte> bytes() const;
+
+        // text() and blob() throw std::out_of_range if row >= size() and
+        // std::logic_error if the column holds neither text nor blobs.
+        std::string_view text(std::size_t row) const;
+
+        std::span<const std::byte> blob(std::size_t row) const;
+
+    private:
+        explicit Column(std::string name);
+
+        void checkRow(std::size_t row) const;
+
+        void append(const Row& row, int column);
+
+        void setType(ColumnType type);
+
+        void appendBytes(std::span<const std::byte> bytes);
+
+        std::string                m_name;
+        ColumnType                 m_type;
+        std::size_t                m_size;
+        std::vector<std::uint64_t> m_validity;
+        std::vector<sqlite3_int64> m_integers;
+        std::vector<double>        m_reals;
+        std::vector<std::size_t>   m_offsets;
+        std::vector<std::byte>     m_bytes;
+    };
+
+    explicit ColumnarResult(const Row& row);
+
+    void append(const Row& row);
+
+    std::size_t rowCount() const;
+
+    std::size_t columnCount() const;
+
+    const Column& column(std::size_t index) const;
+
+private:
+    std::size_t         m_rowCount;
+    std::vector<Column> m_columns;
+};
+} // namespace sqlite
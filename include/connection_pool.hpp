@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "database_connection.hpp"
+
+namespace sqlite {
+// A fixed set of pre-opened connections. A checked out connection belongs
+// to the calling thread alone until its handle is destroyed, so the pool is
+// safe to use with SQLITE_OPEN_NOMUTEX. Threads are preferably handed the
+// connection they used last.
+class ConnectionPool {
+public:
+    class Handle {
+    public:
+        friend class ConnectionPool;
+
+        Handle(const Handle&) = delete;
+
+        Handle(Handle&& other) noexcept;
+
+        Handle& operator=(const Handle&) = delete;
+
+        Handle& operator=(Handle&& other) noexcept;
+
+        ~Handle();
+
+        DatabaseConnection& operator*() const;
+
+        DatabaseConnection* operator->() const;
+
+    private:
+        Handle(ConnectionPool* pool, std::size_t slotIndex);
+
+        ConnectionPool* m_pool;
+        std::size_t     m_slotIndex;
+    };
+
+    ConnectionPool(
+        const char* filename,
+        int         flags,
+        const char* vfsModuleName,
+        std::size_t size);
+
+    ConnectionPool(const ConnectionPool&) = delete;
+
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    // Blocks until a connection is idle.
+    Handle checkout();
+
+    std::size_t size() const;
+
+    std::size_t idleCount() const;
+
+private:
+    struct Slot {
+        DatabaseConnection connection;
+        std::thread::id    lastOwner;
+    };
+
+    void checkin(std::size_t slotIndex);
+
+    mutable std::mutex       m_mutex;
+    std::condition_variable  m_connectionReturned;
+    std::vector<Slot>        m_slots;
+    std::vector<std::size_t> m_idleSlots;
+};
+} // namespace sqlite
@@ -1,18 +1,47 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include <memory>
 #include <stdexcept>
 
 #include <sqlite3.h>
 
 #include "exception.hpp"
 #include "prepared_statement.hpp"
+#include "statement_cache.hpp"
+#include "transaction.hpp"
 
 namespace sqlite {
 class DatabaseConnection {
 public:
+    friend class Transaction;
+
+    // Counters of sqlite3_db_status. The cache and lookaside hit and miss
+    // counts accumulate since the connection was opened; the byte counts
+    // and lookasideSlotsUsed are the current usage.
+    struct Stats {
+        std::int64_t cacheHits;
+        std::int64_t cacheMisses;
+        std::int64_t cacheWrites;
+        std::int64_t cacheSpills;
+        std::int64_t cacheBytes;
+        std::int64_t lookasideSlotsUsed;
+        std::int64_t lookasideHits;
+        std::int64_t lookasideMissesSize;
+        std::int64_t lookasideMissesFull;
+        std::int64_t schemaBytes;
+        std::int64_t statementBytes;
+
+        // The change from before to this snapshot.
+        Stats operator-(const Stats& before) const;
+    };
+
     DatabaseConnection(
         const char* filename,
         int         flags,
-        const char* vfsModuleName);
+        const char* vfsModuleName,
+        std::size_t statementCacheCapacity = 16);
 
     DatabaseConnection(const DatabaseConnection&) = delete;
 
@@ -26,7 +55,26 @@ public:
 
     PreparedStatement prepareStatement(const char* sqlStatement);
 
+    // The returned handle puts the statement back into the cache of this
+    // connection and must not outlive it.
+    StatementCache::Handle cachedStatement(const char* sqlStatement);
+
+    StatementCache::Statistics statementCacheStatistics() const;
+
+    Stats stats() const;
+
+    // Runs a statement that doesn't return any rows using the statement
+    // cache.
+    void execute(const char* sqlStatement);
+
+    Transaction transaction(
+        Transaction::Mode mode = Transaction::Mode::Deferred);
+
 private:
-    sqlite3* m_connection;
+    std::int64_t status(int operation, bool highwater) const;
+
+    sqlite3*                        m_connection;
+    std::unique_ptr<StatementCache> m_statementCache;
+    std::size_t                     m_transactionDepth;
 };
 } // namespace sqlite
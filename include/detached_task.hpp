@@ -0,0 +1,36 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+
+namespace sqlite {
+// Return type of fire-and-forget coroutines: the coroutine starts right
+// away and frees itself when it finishes. Nothing can wait for it, so it
+// has to catch its own exceptions; an escaping exception terminates.
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        void return_void() const noexcept
+        {
+        }
+
+        void unhandled_exception() const noexcept
+        {
+            std::terminate();
+        }
+    };
+};
+} // namespace sqlite
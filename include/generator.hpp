@@ -0,0 +1,155 @@
+#pragma once
+#include <cstddef>
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace sqlite {
+// Lazily evaluated coroutine range. The body runs up to the next co_yield on
+// every increment; a yielded value is only valid until then.
+// Exceptions thrown by the body are rethrown from begin() or operator++().
+template <typename T>
+class Generator {
+public:
+    struct promise_type {
+        Generator get_return_object()
+        {
+            return Generator{Handle::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_always final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_always yield_value(T& value) noexcept
+        {
+            m_value = std::addressof(value);
+            return {};
+        }
+
+        std::suspend_always yield_value(T&& value) noexcept
+        {
+            m_value = std::addressof(value);
+            return {};
+        }
+
+        void return_void() const noexcept
+        {
+        }
+
+        void unhandled_exception()
+        {
+            m_exception = std::current_exception();
+        }
+
+        // co_await is not supported inside a generator.
+        void await_transform() = delete;
+
+        T*                 m_value{nullptr};
+        std::exception_ptr m_exception{};
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = T*;
+        using reference         = T&;
+
+        Iterator() : m_coroutine{}
+        {
+        }
+
+        explicit Iterator(Handle coroutine) : m_coroutine{coroutine}
+        {
+        }
+
+        T& operator*() const
+        {
+            return *m_coroutine.promise().m_value;
+        }
+
+        Iterator& operator++()
+        {
+            resume(m_coroutine);
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            ++*this;
+        }
+
+        bool operator==(std::default_sentinel_t) const
+        {
+            return m_coroutine.done();
+        }
+
+    private:
+        Handle m_coroutine;
+    };
+
+    explicit Generator(Handle coroutine) : m_coroutine{coroutine}
+    {
+    }
+
+    Generator(const Generator&) = delete;
+
+    Generator(Generator&& other) noexcept
+        : m_coroutine{std::exchange(other.m_coroutine, nullptr)}
+    {
+    }
+
+    Generator& operator=(const Generator&) = delete;
+
+    Generator& operator=(Generator&& other) noexcept
+    {
+        std::swap(m_coroutine, other.m_coroutine);
+        return *this;
+    }
+
+    ~Generator()
+    {
+        if (m_coroutine) {
+            m_coroutine.destroy();
+        }
+    }
+
+    // Runs the body up to the first co_yield.
+    Iterator begin()
+    {
+        resume(m_coroutine);
+        return Iterator{m_coroutine};
+    }
+
+    std::default_sentinel_t end() const noexcept
+    {
+        return std::default_sentinel;
+    }
+
+private:
+    static void resume(Handle coroutine)
+    {
+        coroutine.resume();
+
+        if (coroutine.promise().m_exception) {
+            std::rethrow_exception(
+                std::exchange(coroutine.promise().m_exception, nullptr));
+        }
+    }
+
+    Handle m_coroutine;
+};
+} // namespace sqlite
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+
+namespace sqlite {
+// HDR-style log-linear histogram of latencies in nanoseconds. Every power of
+// two is split into 32 sub-buckets, which bounds the relative error of a
+// percentile to about 3%; latencies below 64 ns are exact and latencies
+// from 2^42 ns (about 73 minutes) on are clamped.
+// record() is meant for a single writing thread and is lock-free; other
+// threads may read or merge the histogram concurrently.
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram& other);
+
+    LatencyHistogram& operator=(const LatencyHistogram& other);
+
+    void record(std::chrono::nanoseconds latency) noexcept;
+
+    // Adds the counts of other to this histogram.
+    void merge(const LatencyHistogram& other) noexcept;
+
+    void reset() noexcept;
+
+    std::uint64_t count() const noexcept;
+
+    std::chrono::nanoseconds total() const noexcept;
+
+    std::chrono::nanoseconds max() const noexcept;
+
+    // The latency below which percentile percent of the recorded latencies
+    // fall, e.g. percentile(99.9). Returns 0 for an empty histogram.
+    std::chrono::nanoseconds percentile(double percentile) const noexcept;
+
+private:
+    static constexpr int         subBucketBits{5};
+    static constexpr std::size_t subBucketCount{
+        std::size_t{1} << subBucketBits};
+    static constexpr int         maxShift{36};
+    static constexpr std::size_t bucketCount{
+        2 * subBucketCount + maxShift * subBucketCount};
+
+    static std::size_t bucketIndex(std::uint64_t nanoseconds) noexcept;
+
+    // The highest latency that falls into the bucket.
+    static std::uint64_t bucketUpperBound(std::size_t index) noexcept;
+
+    std::array<std::atomic<std::uint64_t>, bucketCount> m_buckets;
+    std::atomic<std::uint64_t>                          m_count;
+    std::atomic<std::uint64_t>                          m_totalNanoseconds;
+    std::atomic<std::uint64_t>                          m_maxNanoseconds;
+};
+} // namespace sqlite
@@ -0,0 +1,25 @@
+#pragma once
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "latency_histogram.hpp"
+
+namespace sqlite {
+struct StatementLatency {
+    std::string      sql;
+    LatencyHistogram histogram;
+};
+
+// Records latency for sql in a histogram owned by the calling thread.
+// Only the first latency a thread records for an SQL text takes a lock.
+void recordLatency(std::string_view sql, std::chrono::nanoseconds latency);
+
+// Merges the histograms of every thread, including the ones of threads
+// that have exited, into one histogram per SQL text, ordered by SQL.
+std::vector<StatementLatency> latencySnapshot();
+
+// Clears every histogram. Latencies recorded meanwhile may be lost.
+void resetLatencies();
+} // namespace sqlite
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include <string_view>
+
+namespace sqlite {
+// The name of a named parameter such as ":email" together with its hash,
+// which is computed at compile time for constant names. Statements cache
+// the parameter index per hash and check the name on a hit, so binding by
+// name only looks the name up once per statement.
+class ParameterName {
+public:
+    constexpr explicit ParameterName(std::string_view name)
+        : m_name{name}, m_hash{hashOf(name)}
+    {
+    }
+
+    constexpr std::string_view name() const
+    {
+        return m_name;
+    }
+
+    constexpr std::uint64_t hash() const
+    {
+        return m_hash;
+    }
+
+private:
+    // 64 bit FNV-1a.
+    static constexpr std::uint64_t hashOf(std::string_view name)
+    {
+        std::uint64_t hash{14695981039346656037ULL};
+
+        for (const char character : name) {
+            hash ^= static_cast<unsigned char>(character);
+            hash *= 1099511628211ULL;
+        }
+
+        return hash;
+    }
+
+    std::string_view m_name;
+    std::uint64_t    m_hash;
+};
+
+namespace literals {
+// statement.bind(":email"_param, email);
+consteval ParameterName operator""_param(const char* name, std::size_t size)
+{
+    return ParameterName{std::string_view{name, size}};
+}
+} // namespace literals
+} // namespace sqlite
@@ -1,23 +1,51 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include <memory_resource>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <variant>
 #include <vector>
 
 #include <sqlite3.h>
 
+#include "bind_traits.hpp"
+#include "borrowed.hpp"
+#include "column_traits.hpp"
+#include "columnar_result.hpp"
 #include "exception.hpp"
+#include "generator.hpp"
+#include "parameter_name.hpp"
+#include "row.hpp"
+#include "row_cursor.hpp"
+#include "scan_status.hpp"
+#include "statement_costs.hpp"
+#include "throw.hpp"
 
 namespace sqlite {
 class PreparedStatement {
 public:
-    using Variant = std::variant<sqlite_int64, double, std::string>;
+    using Variant    = Row::Variant;
+    using PmrVariant = Row::PmrVariant;
 
     PreparedStatement(
         sqlite3*      db,
         sqlite3_stmt* statement,
         const char*   sqlQuery);
 
+    PreparedStatement(const PreparedStatement&) = delete;
+
+    PreparedStatement(PreparedStatement&& other) noexcept;
+
+    PreparedStatement& operator=(const PreparedStatement&) = delete;
+
+    PreparedStatement& operator=(PreparedStatement&& other) noexcept;
+
     ~PreparedStatement();
 
     void bind(int placeholderIndex, double value);
@@ -28,13 +56,165 @@ public:
 
     void bind(int placeholderIndex, const char* text);
 
+    // Text and blobs are copied by SQLite, unless they're borrowed.
+    void bind(int placeholderIndex, std::string_view text);
+
+    void bind(int placeholderIndex, BorrowedText text);
+
+    void bind(int placeholderIndex, std::span<const std::byte> bytes);
+
+    void bind(int placeholderIndex, BorrowedBlob bytes);
+
+    // Binds values to the parameters 1 to sizeof...(Values) through
+    // BindTraits, checking the result codes once.
+    template <typename... Values>
+    void bindAll(const Values&... values)
+    {
+        bindAll(std::index_sequence_for<Values...>{}, values...);
+    }
+
+    int parameterCount() const;
+
+    // Resolves the index of a named parameter on first use and caches it.
+    int parameterIndex(const ParameterName& name);
+
+    template <typename Value>
+    void bind(const ParameterName& name, const Value& value)
+    {
+        const int resultCode{BindTraits<std::decay_t<Value>>::bind(
+            m_statement, parameterIndex(name), value)};
+
+        if (resultCode != SQLITE_OK) {
+            throwBindError(resultCode);
+        }
+    }
+
     std::vector<std::vector<Variant>> run();
 
+    // Like run(), but records how long it took in the calling thread's
+    // latency histogram for this SQL, see latencySnapshot().
     std::vector<std::vector<Variant>> runProfiled();
 
+    ColumnarResult runColumnar();
+
+    // Allocates the whole result set from memoryResource, typically a
+    // std::pmr::monotonic_buffer_resource per query that frees every row at
+    // once.
+    std::pmr::vector<std::pmr::vector<PmrVariant>> run(
+        std::pmr::memory_resource* memoryResource);
+
+    // Like run(), but decodes every row straight into a Tuple.
+    template <typename Tuple>
+    std::vector<Tuple> run()
+    {
+        return query<Tuple>();
+    }
+
+    // Decodes every row straight into T, see RowColumns.
+    template <typename T>
+    std::vector<T> query()
+    {
+        using Reader = RowReader<T, typename RowColumns<T>::type>;
+        static_assert(
+            !Reader::containsViews,
+            "Views are only valid until the next step, use rows() and "
+            "Row::as() to read them.");
+        std::vector<T> result{};
+
+        while (step()) {
+            result.push_back(Reader::read(m_statement));
+        }
+
+        return result;
+    }
+
+    // Steps the statement once. Returns true if a row is available through
+    // row() and false once the statement is done.
+    bool step();
+
+    Row row() const;
+
+    // Streams the result instead of collecting it like run() does.
+    RowRange rows();
+
+    // Yields every row as sqlite3_step produces it; each Row is valid until
+    // the generator is advanced.
+    Generator<Row> generateRows();
+
+    // Calls function(Row) for every row without collecting anything and
+    // returns the number of rows.
+    template <typename Function>
+    std::size_t forEach(Function&& function)
+    {
+        std::size_t rowCount{0};
+
+        while (step()) {
+            function(Row{m_statement});
+            ++rowCount;
+        }
+
+        return rowCount;
+    }
+
+    // Makes the statement ready to be run again; bindings are kept.
+    // Errors of the previous run have already been thrown by run().
+    void reset() noexcept;
+
+    void clearBindings() noexcept;
+
+    // The sqlite3_stmt_status counters since the statement was prepared or,
+    // with cost accounting enabled, since it was last reset.
+    StatementCosts costs() const;
+
+#ifdef SQLITE_ENABLE_STMT_SCANSTATUS
+    // The query plan figures of the runs since the statement was prepared
+    // or since resetScanStatus(), see formatScanStatus().
+    std::vector<PlanElementStatus> scanStatus() const;
+
+    void resetScanStatus() noexcept;
+#endif
+
 private:
-    sqlite3*      m_db;
-    sqlite3_stmt* m_statement;
-    const char*   m_sqlQuery;
+    template <std::size_t... Indices, typename... Values>
+    void bindAll(std::index_sequence<Indices...>, const Values&... values)
+    {
+        int resultCode{SQLITE_OK};
+        (void)((
+            (resultCode = BindTraits<std::decay_t<Values>>::bind(
+                 m_statement, static_cast<int>(Indices) + 1, values))
+            == SQLITE_OK)
+            && ...);
+
+        if (resultCode != SQLITE_OK) {
+            throwBindError(resultCode);
+        }
+    }
+
+    [[noreturn]] void throwBindError(int resultCode) const;
+
+    std::uint64_t status(int counter, bool resetCounter) const;
+
+    // Moves the counters into the registry of enableCostAccounting().
+    void accumulateCosts() noexcept;
+
+    void bindText(
+        int                     placeholderIndex,
+        std::string_view        text,
+        sqlite3_destructor_type destructor);
+
+    void bindBlob(
+        int                        placeholderIndex,
+        std::span<const std::byte> bytes,
+        sqlite3_destructor_type    destructor);
+
+    struct CachedParameterIndex {
+        std::uint64_t nameHash;
+        int           index;
+    };
+
+    sqlite3*                          m_db;
+    sqlite3_stmt*                     m_statement;
+    const char*                       m_sqlQuery;
+    std::vector<CachedParameterIndex> m_parameterIndices;
 };
 } // namespace sqlite
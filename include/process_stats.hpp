@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+
+namespace sqlite {
+// Process-wide memory usage of SQLite from sqlite3_status64: the memory,
+// the allocations and the page cache currently in use, and the highwater
+// marks since the process started. Everything stays 0 if SQLite was built
+// with SQLITE_DEFAULT_MEMSTATUS=0.
+struct ProcessStats {
+    std::int64_t memoryBytes;
+    std::int64_t memoryHighwaterBytes;
+    std::int64_t outstandingAllocations;
+    std::int64_t largestAllocationBytes;
+    // Pages of the SQLITE_CONFIG_PAGECACHE memory in use, not bytes.
+    std::int64_t pageCachePages;
+    std::int64_t pageCacheOverflowBytes;
+
+    // The change from before to this snapshot. Highwater marks can't be
+    // subtracted, the result keeps the ones of this snapshot.
+    ProcessStats operator-(const ProcessStats& before) const;
+};
+
+ProcessStats processStats();
+} // namespace sqlite
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include <sqlite3.h>
+
+#include "column_traits.hpp"
+
+namespace sqlite {
+// The current row of a statement that is being stepped. Pointers and views
+// returned by the accessors point into SQLite's buffers and are only valid
+// until the next step; toOwned() copies the row.
+class Row {
+public:
+    using Variant = std::variant<
+        sqlite_int64,
+        double,
+        std::string,
+        std::vector<std::byte>>;
+
+    // Allocates its text and blob contents from a memory resource.
+    using PmrVariant = std::variant<
+        sqlite_int64,
+        double,
+        std::pmr::string,
+        std::pmr::vector<std::byte>>;
+
+    explicit Row(sqlite3_stmt* statement);
+
+    int columnCount() const;
+
+    int columnType(int column) const;
+
+    const char* columnName(int column) const;
+
+    sqlite3_int64 int64(int column) const;
+
+    double real(int column) const;
+
+    const char* text(int column) const;
+
+    std::string_view textView(int column) const;
+
+    std::span<const std::byte> blob(int column) const;
+
+    Variant value(int column) const;
+
+    std::vector<Variant> toOwned() const;
+
+    PmrVariant value(int column, std::pmr::memory_resource* memoryResource)
+        const;
+
+    std::pmr::vector<PmrVariant> toOwned(
+        std::pmr::memory_resource* memoryResource) const;
+
+    template <typename T>
+    T get(int column) const
+    {
+        return ColumnTraits<T>::read(m_statement, column);
+    }
+
+    // Decodes the row into T, see RowColumns.
+    template <typename T>
+    T as() const
+    {
+        return RowReader<T, typename RowColumns<T>::type>::read(m_statement);
+    }
+
+private:
+    sqlite3_stmt* m_statement;
+};
+} // namespace sqlite
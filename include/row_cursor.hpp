@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+
+#include <iterator>
+
+#include "row.hpp"
+
+namespace sqlite {
+class PreparedStatement;
+
+// Input iterator that steps its statement lazily, one row per increment.
+// Every dereferenced Row is invalidated by the next increment.
+class RowIterator {
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type        = Row;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = const Row*;
+    using reference         = Row;
+
+    RowIterator();
+
+    explicit RowIterator(PreparedStatement* statement);
+
+    Row operator*() const;
+
+    RowIterator& operator++();
+
+    void operator++(int);
+
+    bool operator==(std::default_sentinel_t) const;
+
+private:
+    PreparedStatement* m_statement;
+};
+
+// for (sqlite::Row row : statement.rows()) { ... }
+class RowRange {
+public:
+    explicit RowRange(PreparedStatement* statement);
+
+    // Steps to the first row.
+    RowIterator begin() const;
+
+    std::default_sentinel_t end() const;
+
+private:
+    PreparedStatement* m_statement;
+};
+} // namespace sqlite
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace sqlite {
+struct ScalingPoint {
+    std::size_t   threadCount;
+    std::uint64_t queryCount;
+    std::uint64_t rowCount;
+    double        milliseconds;
+
+    double queriesPerSecond() const;
+
+    double rowsPerSecond() const;
+};
+
+// Throughput of one configuration over increasing thread counts.
+struct ScalingCurve {
+    std::string               threadingMode;
+    std::string               connections;
+    std::vector<ScalingPoint> points;
+
+    // The index of the first point that reaches kneeFraction of the best
+    // throughput of the curve: more threads than that hardly pay off.
+    std::optional<std::size_t> kneeIndex() const;
+
+    static constexpr double kneeFraction{0.9};
+};
+
+// 1, 2, 4, ... up to and including maximum.
+std::vector<std::size_t> sweepThreadCounts(std::size_t maximum);
+
+// One row per point; the knee column is true for the knee of each curve.
+void writeScalingCsv(std::ostream& os, const std::vector<ScalingCurve>& curves);
+} // namespace sqlite
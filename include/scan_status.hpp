@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace sqlite {
+// What sqlite3_stmt_scanstatus_v2 reports for one element of the query
+// plan of a statement, the same elements EXPLAIN QUERY PLAN shows.
+// Figures SQLite doesn't have for an element are empty.
+struct PlanElementStatus {
+    int                         selectId;
+    int                         parentId;
+    std::string                 explain;
+    std::string                 name;
+    std::optional<std::int64_t> loopCount;
+    std::optional<std::int64_t> visitedRowCount;
+    std::optional<double>       estimatedRowsPerLoop;
+    std::optional<std::int64_t> cycleCount;
+
+    // visitedRowCount / loopCount, to compare with estimatedRowsPerLoop.
+    std::optional<double> actualRowsPerLoop() const;
+};
+
+// One line per element, indented like EXPLAIN QUERY PLAN, with the
+// estimated and the actual rows per loop side by side.
+std::string formatScanStatus(const std::vector<PlanElementStatus>& elements);
+} // namespace sqlite
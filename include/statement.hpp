@@ -0,0 +1,63 @@
+#pragma once
+#include <utility>
+#include <vector>
+
+#include "prepared_statement.hpp"
+#include "throw.hpp"
+
+namespace sqlite {
+template <typename Signature>
+class Statement;
+
+// A prepared statement with a parameter list fixed at compile time, e.g.
+// Statement<void(std::string_view, sqlite3_int64)>. Calling it converts the
+// arguments to the parameter types, binds them in one go and runs it. For a
+// Result other than void every row is decoded into Result as by
+// PreparedStatement::query().
+template <typename Result, typename... Parameters>
+class Statement<Result(Parameters...)> {
+public:
+    explicit Statement(PreparedStatement statement)
+        : m_statement{std::move(statement)}
+    {
+        const int expected{static_cast<int>(sizeof...(Parameters))};
+        const int actual{m_statement.parameterCount()};
+
+        if (actual != expected) {
+            SQLITE_THROW(
+                Exception,
+                SQLITE_RANGE,
+                "Statement signature has {} parameters, but the SQL has {}.",
+                expected,
+                actual);
+        }
+    }
+
+    void bind(const Parameters&... parameters)
+    {
+        m_statement.bindAll(parameters...);
+    }
+
+    auto operator()(const Parameters&... parameters)
+    {
+        m_statement.reset();
+        bind(parameters...);
+
+        if constexpr (std::is_void_v<Result>) {
+            while (m_statement.step()) {
+            }
+        }
+        else {
+            return m_statement.template query<Result>();
+        }
+    }
+
+    PreparedStatement& statement()
+    {
+        return m_statement;
+    }
+
+private:
+    PreparedStatement m_statement;
+};
+} // namespace sqlite
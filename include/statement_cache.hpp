@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "prepared_statement.hpp"
+
+namespace sqlite {
+class DatabaseConnection;
+
+// LRU cache of idle prepared statements keyed by their SQL text.
+// A statement is removed from the cache while it is checked out, so the same
+// SQL may be in use by several threads at once on a FULLMUTEX connection.
+class StatementCache {
+private:
+    struct Entry {
+        std::string                        sql;
+        std::unique_ptr<PreparedStatement> statement;
+    };
+
+public:
+    struct Statistics {
+        std::uint64_t hits;
+        std::uint64_t misses;
+        std::uint64_t evictions;
+        // Idle statements kept in the cache, not the checked-out ones.
+        std::size_t   size;
+        std::size_t   capacity;
+    };
+
+    class Handle {
+    public:
+        friend class StatementCache;
+
+        Handle(const Handle&) = delete;
+
+        Handle(Handle&& other) noexcept;
+
+        Handle& operator=(const Handle&) = delete;
+
+        Handle& operator=(Handle&& other) noexcept;
+
+        ~Handle();
+
+        PreparedStatement& operator*() const;
+
+        PreparedStatement* operator->() const;
+
+    private:
+        Handle(StatementCache* cache, std::list<Entry> entry);
+
+        StatementCache*  m_cache;
+        std::list<Entry> m_entry;
+    };
+
+    explicit StatementCache(std::size_t capacity);
+
+    StatementCache(const StatementCache&) = delete;
+
+    StatementCache& operator=(const StatementCache&) = delete;
+
+    // Returns a reset statement without bindings for sqlStatement, preparing
+    // it on connection if there is no idle one.
+    Handle acquire(DatabaseConnection& connection, const char* sqlStatement);
+
+    Statistics statistics() const;
+
+private:
+    void release(std::list<Entry>& entry);
+
+    mutable std::mutex m_mutex;
+    const std::size_t  m_capacity;
+    std::list<Entry>   m_entries;
+    std::unordered_multimap<std::string_view, std::list<Entry>::iterator>
+                  m_index;
+    std::uint64_t m_hits;
+    std::uint64_t m_misses;
+    std::uint64_t m_evictions;
+};
+} // namespace sqlite
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sqlite {
+// The sqlite3_stmt_status counters of a prepared statement. fullScanSteps,
+// sortCount and autoIndexCount flag queries that miss an index.
+struct StatementCosts {
+    std::uint64_t vmSteps;
+    std::uint64_t fullScanSteps;
+    std::uint64_t sortCount;
+    std::uint64_t autoIndexCount;
+    std::uint64_t reprepareCount;
+    std::uint64_t runCount;
+    // Heap memory of the statement; a size, so adding keeps the larger one.
+    std::uint64_t memoryBytes;
+
+    StatementCosts& operator+=(const StatementCosts& other);
+};
+
+struct SqlCosts {
+    std::string    sql;
+    StatementCosts costs;
+};
+
+// While cost accounting is enabled, every PreparedStatement adds its costs
+// to a registry keyed by its SQL text whenever it is reset or finalized.
+// Disabled by default.
+void enableCostAccounting(bool enabled);
+
+bool costAccountingEnabled();
+
+void accumulateCosts(std::string_view sql, const StatementCosts& costs);
+
+// The accumulated costs ordered by VM steps, most first.
+std::vector<SqlCosts> accumulatedCosts();
+
+void resetAccumulatedCosts();
+} // namespace sqlite
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sqlite3.h>
+
+namespace sqlite {
+// What every run of the statements with one normalized SQL text added up to.
+struct StatementProfile {
+    std::string              sql;
+    std::uint64_t            runCount;
+    std::uint64_t            rowCount;
+    std::chrono::nanoseconds totalTime;
+    std::chrono::nanoseconds minTime;
+    std::chrono::nanoseconds maxTime;
+};
+
+// Profiles every statement that runs on connection through
+// sqlite3_trace_v2. Each thread aggregates the runs it executes in its own
+// buckets, so the callbacks don't lock except the first time a thread runs
+// an SQL text. DatabaseConnection does this for every connection it opens.
+void enableStatementProfiling(sqlite3* connection);
+
+// Merges the buckets of every thread, including the ones of threads that
+// have exited. Ordered by total time, longest first.
+std::vector<StatementProfile> statementProfiles();
+
+// Clears every bucket. Runs that finish meanwhile may be lost.
+void resetStatementProfiles();
+
+// Replaces string, blob and numeric literals with ? and collapses
+// whitespace, so that statements differing only in literals are profiled
+// together.
+std::string normalizeSql(std::string_view sql);
+} // namespace sqlite
@@ -0,0 +1,14 @@
+#pragma once
+
+namespace sqlite {
+// The process-wide threading modes of sqlite3_config. SQLITE_OPEN_NOMUTEX
+// and SQLITE_OPEN_FULLMUTEX override MultiThread and Serialized per
+// connection; SingleThread disables every mutex and cannot be overridden.
+enum class ThreadingMode { SingleThread, MultiThread, Serialized };
+
+const char* threadingModeName(ThreadingMode mode);
+
+// Shuts SQLite down and initializes it again in mode. Every connection has
+// to be closed beforehand.
+void configureThreadingMode(ThreadingMode mode);
+} // namespace sqlite
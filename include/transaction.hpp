@@ -0,0 +1,38 @@
+#pragma once
+#include <string>
+
+namespace sqlite {
+class DatabaseConnection;
+
+// Rolls back on destruction unless committed. A transaction started while
+// another one is active on the same connection becomes a savepoint nested
+// inside it, in which case the mode is ignored.
+class Transaction {
+public:
+    enum class Mode { Deferred, Immediate, Exclusive };
+
+    Transaction(DatabaseConnection& connection, Mode mode);
+
+    Transaction(const Transaction&) = delete;
+
+    Transaction(Transaction&& other) noexcept;
+
+    Transaction& operator=(const Transaction&) = delete;
+
+    Transaction& operator=(Transaction&& other) noexcept;
+
+    ~Transaction();
+
+    void commit();
+
+    void rollback();
+
+    bool isSavepoint() const;
+
+private:
+    void finish(const char* topLevelStatement, bool rollBackSavepoint);
+
+    DatabaseConnection* m_connection;
+    std::string         m_savepoint;
+};
+} // namespace sqlite
@@ -0,0 +1,50 @@
+#include <cstdlib>
+
+#include <atomic>
+#include <new>
+
+#include "allocation_counter.hpp"
+
+namespace sqlite {
+namespace {
+std::atomic<std::uint64_t> globalAllocationCount{0};
+} // anonymous namespace
+
+std::uint64_t allocationCount()
+{
+    return globalAllocationCount.load(std::memory_order_relaxed);
+}
+} // namespace sqlite
+
+// The array and sized forms forward to these by default.
+void* operator new(std::size_t byteCount)
+{
+    sqlite::globalAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* const memory{std::malloc(byteCount == 0 ? 1 : byteCount)}) {
+        return memory;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t byteCount, const std::nothrow_t&) noexcept
+{
+    sqlite::globalAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(byteCount == 0 ? 1 : byteCount);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
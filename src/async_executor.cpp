@@ -0,0 +1,203 @@
+#include <cstdio>
+
+#include <chrono>
+#include <stdexcept>
+
+#include "async_executor.hpp"
+
+namespace sqlite {
+namespace {
+// Identifies the worker running on the current thread, if any.
+thread_local const AsyncExecutor* currentExecutor{nullptr};
+thread_local std::size_t          currentWorkerIndex{0};
+} // anonymous namespace
+
+AsyncExecutor::Worker::Worker(
+    const char* filename,
+    int         flags,
+    const char* vfsModuleName)
+    : mutex{}
+    , tasks{}
+    , connection{filename, flags, vfsModuleName}
+    , thread{}
+    , taskCount{0}
+    , stolenTaskCount{0}
+    , busyNanoseconds{0}
+{
+}
+
+AsyncExecutor::AsyncExecutor(
+    const char* filename,
+    int         flags,
+    const char* vfsModuleName,
+    std::size_t threadCount)
+    : m_mutex{}
+    , m_taskAvailable{}
+    , m_stopping{false}
+    , m_queuedTaskCount{0}
+    , m_nextWorker{0}
+    , m_workers{}
+{
+    m_workers.reserve(threadCount);
+
+    for (std::size_t i{0}; i < threadCount; ++i) {
+        m_workers.push_back(
+            std::make_unique<Worker>(filename, flags, vfsModuleName));
+    }
+
+    for (std::size_t i{0}; i < m_workers.size(); ++i) {
+        m_workers[i]->thread
+            = std::thread{&AsyncExecutor::workerFunction, this, i};
+    }
+}
+
+AsyncExecutor::~AsyncExecutor()
+{
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        m_stopping = true;
+    }
+
+    m_taskAvailable.notify_all();
+
+    for (const std::unique_ptr<Worker>& worker : m_workers) {
+        worker->thread.join();
+    }
+}
+
+void AsyncExecutor::dispatch(Task task)
+{
+    enqueue([task = std::move(task)](DatabaseConnection& connection) mutable {
+        try {
+            task(connection);
+        }
+        catch (const std::exception& ex) {
+            std::fprintf(
+                stderr, "AsyncExecutor: task failed: \"%s\"\n", ex.what());
+        }
+    });
+}
+
+std::size_t AsyncExecutor::threadCount() const
+{
+    return m_workers.size();
+}
+
+std::uint64_t AsyncExecutor::stealCount() const
+{
+    std::uint64_t stealCount{0};
+
+    for (const std::unique_ptr<Worker>& worker : m_workers) {
+        stealCount += worker->stolenTaskCount.load(std::memory_order_relaxed);
+    }
+
+    return stealCount;
+}
+
+std::vector<AsyncExecutor::WorkerStatistics> AsyncExecutor::workerStatistics()
+    const
+{
+    std::vector<WorkerStatistics> statistics{};
+    statistics.reserve(m_workers.size());
+
+    for (const std::unique_ptr<Worker>& worker : m_workers) {
+        statistics.push_back(WorkerStatistics{
+            worker->taskCount.load(std::memory_order_relaxed),
+            worker->stolenTaskCount.load(std::memory_order_relaxed),
+            std::chrono::nanoseconds{
+                worker->busyNanoseconds.load(std::memory_order_relaxed)}});
+    }
+
+    return statistics;
+}
+
+void AsyncExecutor::enqueue(Task task)
+{
+    const std::size_t workerIndex{
+        currentExecutor == this
+            ? currentWorkerIndex
+            : m_nextWorker.fetch_add(1, std::memory_order_relaxed)
+                  % m_workers.size()};
+    Worker& worker{*m_workers[workerIndex]};
+    m_queuedTaskCount.fetch_add(1, std::memory_order_release);
+
+    {
+        const std::lock_guard<std::mutex> lock{worker.mutex};
+        worker.tasks.push_back(std::move(task));
+    }
+
+    // Taking m_mutex orders the count above before the predicate check of
+    // a worker that is about to sleep, so the wake-up cannot be missed.
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+    }
+
+    m_taskAvailable.notify_one();
+}
+
+bool AsyncExecutor::takeTask(std::size_t workerIndex, Task& task)
+{
+    {
+        Worker&                           worker{*m_workers[workerIndex]};
+        const std::lock_guard<std::mutex> lock{worker.mutex};
+
+        if (!worker.tasks.empty()) {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            m_queuedTaskCount.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    for (std::size_t i{1}; i < m_workers.size(); ++i) {
+        Worker& victim{*m_workers[(workerIndex + i) % m_workers.size()]};
+        const std::lock_guard<std::mutex> lock{victim.mutex};
+
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            m_queuedTaskCount.fetch_sub(1, std::memory_order_relaxed);
+            m_workers[workerIndex]->stolenTaskCount.fetch_add(
+                1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void AsyncExecutor::workerFunction(std::size_t workerIndex)
+{
+    currentExecutor    = this;
+    currentWorkerIndex = workerIndex;
+    Worker& worker{*m_workers[workerIndex]};
+
+    for (;;) {
+        Task task{};
+
+        if (takeTask(workerIndex, task)) {
+            const std::chrono::steady_clock::time_point start{
+                std::chrono::steady_clock::now()};
+            task(worker.connection);
+            worker.busyNanoseconds.fetch_add(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count(),
+                std::memory_order_relaxed);
+            worker.taskCount.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock{m_mutex};
+        m_taskAvailable.wait(lock, [this] {
+            return m_stopping
+                   || m_queuedTaskCount.load(std::memory_order_acquire) != 0;
+        });
+
+        if (m_stopping
+            && m_queuedTaskCount.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+} // namespace sqlite
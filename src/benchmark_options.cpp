@@ -0,0 +1,217 @@
+#include <charconv>
+#include <stdexcept>
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include "benchmark_options.hpp"
+
+namespace sqlite {
+static std::size_t parseCount(
+    std::string_view option,
+    std::string_view value,
+    std::size_t      minimum)
+{
+    std::size_t                  count{0};
+    const char* const            end{value.data() + value.size()};
+    const std::from_chars_result result{
+        std::from_chars(value.data(), end, count)};
+
+    if (result.ec != std::errc{} || result.ptr != end || count < minimum) {
+        throw std::runtime_error{fmt::format(
+            "Invalid value for {}: \"{}\", expected an integer of at least {}",
+            option,
+            value,
+            minimum)};
+    }
+
+    return count;
+}
+
+// Parses comma separated kind=weight pairs; kinds left out get weight 0.
+static QueryMix parseQueryMix(std::string_view value)
+{
+    QueryMix queryMix{0, 0, 0};
+
+    while (!value.empty()) {
+        const std::size_t      comma{value.find(',')};
+        const std::string_view entry{value.substr(0, comma)};
+        value = comma == std::string_view::npos ? std::string_view{}
+                                                : value.substr(comma + 1);
+        const std::size_t equals{entry.find('=')};
+
+        if (equals == std::string_view::npos) {
+            throw std::runtime_error{fmt::format(
+                "Invalid --query-mix entry: \"{}\", expected kind=weight",
+                entry)};
+        }
+
+        const std::string_view kind{entry.substr(0, equals)};
+        const std::size_t      weight{
+            parseCount("--query-mix", entry.substr(equals + 1), 0)};
+
+        if (kind == "scan") {
+            queryMix.scan = weight;
+        }
+        else if (kind == "point") {
+            queryMix.point = weight;
+        }
+        else if (kind == "join") {
+            queryMix.join = weight;
+        }
+        else {
+            throw std::runtime_error{fmt::format(
+                "Unknown --query-mix kind: \"{}\", expected scan, point or "
+                "join",
+                kind)};
+        }
+    }
+
+    if (queryMix.scan + queryMix.point + queryMix.join == 0) {
+        throw std::runtime_error{"--query-mix needs a non-zero weight"};
+    }
+
+    return queryMix;
+}
+
+static ReportFormat parseReportFormat(std::string_view value)
+{
+    for (const ReportFormat format :
+         {ReportFormat::Text, ReportFormat::Json, ReportFormat::Csv}) {
+        if (value == reportFormatName(format)) {
+            return format;
+        }
+    }
+
+    throw std::runtime_error{fmt::format(
+        "Invalid value for --format: \"{}\", expected text, json or csv",
+        value)};
+}
+
+const char* BenchmarkOptions::vfs() const
+{
+    return vfsName.empty() ? nullptr : vfsName.c_str();
+}
+
+bool BenchmarkOptions::reportsToStdout() const
+{
+    return reportFormat != ReportFormat::Text && outputPath == "-";
+}
+
+bool BenchmarkOptions::sweepsToStdout() const
+{
+    return sweepOutputPath == "-";
+}
+
+BenchmarkOptions parseBenchmarkOptions(int argc, const char* const* argv)
+{
+    BenchmarkOptions options{};
+
+    for (int i{1}; i < argc; ++i) {
+        const std::string_view option{argv[i]};
+
+        if (option == "--help" || option == "-h") {
+            options.helpRequested = true;
+            continue;
+        }
+
+        if (i + 1 == argc) {
+            throw std::runtime_error{fmt::format(
+                "Missing value for \"{}\", see --help", option)};
+        }
+
+        const std::string_view value{argv[++i]};
+
+        if (option == "--threads") {
+            options.threadCount = parseCount(option, value, 1);
+        }
+        else if (option == "--iterations") {
+            options.iterationCount = parseCount(option, value, 1);
+        }
+        else if (option == "--rows") {
+            options.rowCount = parseCount(option, value, 1);
+        }
+        else if (option == "--query-mix") {
+            options.queryMix = parseQueryMix(value);
+        }
+        else if (option == "--database") {
+            options.databasePath = value;
+        }
+        else if (option == "--vfs") {
+            options.vfsName = value;
+        }
+        else if (option == "--format") {
+            options.reportFormat = parseReportFormat(value);
+        }
+        else if (option == "--output") {
+            options.outputPath = value;
+        }
+        else if (option == "--sweep-output") {
+            options.sweepOutputPath = value;
+        }
+        else if (option == "--baseline") {
+            options.baselinePath = value;
+        }
+        else {
+            throw std::runtime_error{
+                fmt::format("Unknown option \"{}\", see --help", option)};
+        }
+    }
+
+    if (options.reportsToStdout() && options.sweepsToStdout()) {
+        throw std::runtime_error{
+            "The report and the sweep can't both be written to stdout"};
+    }
+
+    return options;
+}
+
+const char* benchmarkUsage()
+{
+    return "Usage: sqlite_test_app [options]\n"
+           "  --threads N        worker threads (default 10)\n"
+           "  --iterations N     queries per thread (default 500)\n"
+           "  --rows N           customers to insert (default 500)\n"
+           "  --query-mix MIX    weights of the mixed reader workload\n"
+           "                     (default scan=49,point=0,join=1)\n"
+           "  --database PATH    database file, recreated on every run\n"
+           "                     (default test_database.db)\n"
+           "  --vfs NAME         SQLite VFS (default: the default VFS)\n"
+           "  --format FORMAT    report format: text, json or csv\n"
+           "                     (default text)\n"
+           "  --output PATH      json or csv report file, - for stdout\n"
+           "                     (default -)\n"
+           "  --sweep-output PATH\n"
+           "                     run the reader workload at 1, 2, 4, ... up\n"
+           "                     to twice the hardware threads in every\n"
+           "                     threading mode and write the throughput\n"
+           "                     curves as csv to PATH, - for stdout\n"
+           "  --baseline PATH    compare the throughput to a csv report of\n"
+           "                     an earlier run, e.g. of a build with the\n"
+           "                     default SQLITE_BUILD_PROFILE\n"
+           "  --help             print this help\n";
+}
+
+const char* reportFormatName(ReportFormat format)
+{
+    switch (format) {
+    case ReportFormat::Text:
+        return "text";
+    case ReportFormat::Json:
+        return "json";
+    case ReportFormat::Csv:
+        return "csv";
+    }
+
+    return "unknown";
+}
+
+std::string toString(const QueryMix& queryMix)
+{
+    return fmt::format(
+        "scan={},point={},join={}",
+        queryMix.scan,
+        queryMix.point,
+        queryMix.join);
+}
+} // namespace sqlite
@@ -0,0 +1,376 @@
+#include <chrono>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+
+#include <sqlite3.h>
+
+#include "benchmark_report.hpp"
+
+namespace sqlite {
+static std::string jsonString(std::string_view string)
+{
+    std::string result{"\""};
+
+    for (const char c : string) {
+        switch (c) {
+        case '"':
+            result += "\\\"";
+            break;
+        case '\\':
+            result += "\\\\";
+            break;
+        case '\n':
+            result += "\\n";
+            break;
+        case '\t':
+            result += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                result += fmt::format("\\u{:04x}", static_cast<int>(c));
+            }
+            else {
+                result += c;
+            }
+        }
+    }
+
+    result += '"';
+    return result;
+}
+
+static std::string csvField(std::string_view field)
+{
+    if (field.find_first_of(",\"\n") == std::string_view::npos) {
+        return std::string{field};
+    }
+
+    std::string result{"\""};
+
+    for (const char c : field) {
+        if (c == '"') {
+            result += '"';
+        }
+
+        result += c;
+    }
+
+    result += '"';
+    return result;
+}
+
+// Splits a line written by writeCsv() into its fields, undoing csvField().
+static std::vector<std::string> csvFields(std::string_view line)
+{
+    std::vector<std::string> fields{1};
+    bool                     quoted{false};
+
+    for (std::size_t i{0}; i < line.size(); ++i) {
+        const char c{line[i]};
+
+        if (quoted) {
+            if (c != '"') {
+                fields.back() += c;
+            }
+            else if (i + 1 < line.size() && line[i + 1] == '"') {
+                fields.back() += '"';
+                ++i;
+            }
+            else {
+                quoted = false;
+            }
+        }
+        else if (c == '"') {
+            quoted = true;
+        }
+        else if (c == ',') {
+            fields.emplace_back();
+        }
+        else if (c != '\r') {
+            fields.back() += c;
+        }
+    }
+
+    return fields;
+}
+
+double BenchmarkReport::Result::operationsPerSecond() const
+{
+    return milliseconds > 0.0
+               ? static_cast<double>(operationCount) * 1000.0 / milliseconds
+               : 0.0;
+}
+
+BenchmarkReport::BenchmarkReport(BenchmarkOptions options)
+    : m_options{std::move(options)}
+    , m_environment{currentEnvironment()}
+    , m_results{}
+{
+}
+
+void BenchmarkReport::add(Result result)
+{
+    m_results.push_back(std::move(result));
+}
+
+const std::vector<BenchmarkReport::Result>& BenchmarkReport::results() const
+{
+    return m_results;
+}
+
+const char* BenchmarkReport::sqliteBuildProfile()
+{
+#ifdef SQLITE_LIB_PROFILE
+    return SQLITE_LIB_PROFILE;
+#else
+    return "system";
+#endif
+}
+
+void BenchmarkReport::writeJson(std::ostream& os) const
+{
+    os << "{\n  \"environment\": {\n"
+       << "    \"timestamp\": " << jsonString(m_environment.timestamp)
+       << ",\n"
+       << "    \"sqliteVersion\": " << jsonString(m_environment.sqliteVersion)
+       << ",\n"
+       << "    \"sqliteSourceId\": "
+       << jsonString(m_environment.sqliteSourceId) << ",\n"
+       << "    \"sqliteBuildProfile\": "
+       << jsonString(m_environment.sqliteBuildProfile) << ",\n"
+       << "    \"sqliteThreadsafe\": " << m_environment.sqliteThreadsafe
+       << ",\n"
+       << "    \"hardwareConcurrency\": "
+       << m_environment.hardwareConcurrency << ",\n"
+       << "    \"compiler\": " << jsonString(m_environment.compiler) << ",\n"
+       << "    \"operatingSystem\": "
+       << jsonString(m_environment.operatingSystem) << ",\n"
+       << "    \"assertionsEnabled\": "
+       << (m_environment.assertionsEnabled ? "true" : "false") << "\n  },\n";
+    os << "  \"options\": {\n"
+       << "    \"threads\": " << m_options.threadCount << ",\n"
+       << "    \"iterations\": " << m_options.iterationCount << ",\n"
+       << "    \"rows\": " << m_options.rowCount << ",\n"
+       << "    \"queryMix\": " << jsonString(toString(m_options.queryMix))
+       << ",\n"
+       << "    \"database\": " << jsonString(m_options.databasePath) << ",\n"
+       << "    \"vfs\": "
+       << (m_options.vfsName.empty() ? std::string{"null"}
+                                     : jsonString(m_options.vfsName))
+       << "\n  },\n";
+    os << "  \"results\": [";
+
+    for (std::size_t i{0}; i < m_results.size(); ++i) {
+        const Result& result{m_results[i]};
+        os << (i == 0 ? "\n" : ",\n") << "    {\n"
+           << "      \"name\": " << jsonString(result.name) << ",\n"
+           << "      \"operations\": " << result.operationCount << ",\n"
+           << "      \"milliseconds\": "
+           << fmt::format("{:.3f}", result.milliseconds) << ",\n"
+           << "      \"operationsPerSecond\": "
+           << fmt::format("{:.1f}", result.operationsPerSecond()) << ",\n"
+           << "      \"allocationsPerOperation\": "
+           << (result.allocationsPerOperation.has_value()
+                   ? fmt::format("{}", *result.allocationsPerOperation)
+                   : std::string{"null"})
+           << ",\n"
+           << "      \"latencyMicroseconds\": "
+           << (result.latency.has_value()
+                   ? fmt::format(
+                       "{{\"p50\": {:.3f}, \"p90\": {:.3f}, \"p99\": "
+                       "{:.3f}, \"p99.9\": {:.3f}, \"max\": {:.3f}}}",
+                       result.latency->p50,
+                       result.latency->p90,
+                       result.latency->p99,
+                       result.latency->p999,
+                       result.latency->max)
+                   : std::string{"null"})
+           << ",\n"
+           << "      \"workers\": [";
+
+        for (std::size_t j{0}; j < result.workers.size(); ++j) {
+            const WorkerTotals& worker{result.workers[j]};
+            os << (j == 0 ? "" : ", ")
+               << fmt::format(
+                      "{{\"tasks\": {}, \"stolenTasks\": {}, "
+                      "\"busyMilliseconds\": {:.3f}}}",
+                      worker.taskCount,
+                      worker.stolenTaskCount,
+                      worker.busyMilliseconds);
+        }
+
+        os << "]\n    }";
+    }
+
+    os << "\n  ]\n}\n";
+}
+
+void BenchmarkReport::writeCsv(std::ostream& os) const
+{
+    os << "# timestamp," << csvField(m_environment.timestamp) << '\n'
+       << "# sqlite_version," << csvField(m_environment.sqliteVersion) << '\n'
+       << "# sqlite_source_id," << csvField(m_environment.sqliteSourceId)
+       << '\n'
+       << "# sqlite_build_profile,"
+       << csvField(m_environment.sqliteBuildProfile) << '\n'
+       << "# sqlite_threadsafe," << m_environment.sqliteThreadsafe << '\n'
+       << "# hardware_concurrency," << m_environment.hardwareConcurrency
+       << '\n'
+       << "# compiler," << csvField(m_environment.compiler) << '\n'
+       << "# operating_system," << csvField(m_environment.operatingSystem)
+       << '\n'
+       << "# assertions_enabled,"
+       << (m_environment.assertionsEnabled ? "true" : "false") << '\n'
+       << "# threads," << m_options.threadCount << '\n'
+       << "# iterations," << m_options.iterationCount << '\n'
+       << "# rows," << m_options.rowCount << '\n'
+       << "# query_mix," << csvField(toString(m_options.queryMix)) << '\n'
+       << "# database," << csvField(m_options.databasePath) << '\n'
+       << "# vfs," << csvField(m_options.vfsName) << '\n';
+    os << "benchmark,worker,operations,milliseconds,operations_per_second,"
+          "allocations_per_operation,tasks,stolen_tasks,busy_milliseconds,"
+          "p50_us,p90_us,p99_us,p99_9_us,max_us\n";
+
+    for (const Result& result : m_results) {
+        std::uint64_t taskCount{0};
+        std::uint64_t stolenTaskCount{0};
+        double        busyMilliseconds{0.0};
+
+        for (const WorkerTotals& worker : result.workers) {
+            taskCount += worker.taskCount;
+            stolenTaskCount += worker.stolenTaskCount;
+            busyMilliseconds += worker.busyMilliseconds;
+        }
+
+        const std::string latency{
+            result.latency.has_value()
+                ? fmt::format(
+                    "{:.3f},{:.3f},{:.3f},{:.3f},{:.3f}",
+                    result.latency->p50,
+                    result.latency->p90,
+                    result.latency->p99,
+                    result.latency->p999,
+                    result.latency->max)
+                : std::string{",,,,"}};
+        os << fmt::format(
+            "{},all,{},{:.3f},{:.1f},{},{},{},{:.3f},{}\n",
+            csvField(result.name),
+            result.operationCount,
+            result.milliseconds,
+            result.operationsPerSecond(),
+            result.allocationsPerOperation.has_value()
+                ? fmt::format("{}", *result.allocationsPerOperation)
+                : std::string{},
+            taskCount,
+            stolenTaskCount,
+            busyMilliseconds,
+            latency);
+
+        for (std::size_t i{0}; i < result.workers.size(); ++i) {
+            const WorkerTotals& worker{result.workers[i]};
+            os << fmt::format(
+                "{},{},,,,,{},{},{:.3f},,,,,\n",
+                csvField(result.name),
+                i,
+                worker.taskCount,
+                worker.stolenTaskCount,
+                worker.busyMilliseconds);
+        }
+    }
+}
+
+BenchmarkReport::Baseline BenchmarkReport::readCsvBaseline(std::istream& is)
+{
+    Baseline    baseline{"unknown", {}};
+    std::string line{};
+    bool        headerSeen{false};
+
+    while (std::getline(is, line)) {
+        if (line.starts_with("# ")) {
+            const std::vector<std::string> fields{
+                csvFields(std::string_view{line}.substr(2))};
+
+            if (fields.size() == 2 && fields[0] == "sqlite_build_profile") {
+                baseline.sqliteBuildProfile = fields[1];
+            }
+
+            continue;
+        }
+
+        if (!headerSeen) {
+            if (!line.starts_with("benchmark,worker,operations,")) {
+                throw std::runtime_error{
+                    "Not a benchmark report in csv format: \"" + line + "\""};
+            }
+
+            headerSeen = true;
+            continue;
+        }
+
+        const std::vector<std::string> fields{csvFields(line)};
+
+        // Only the totals of a benchmark, the worker rows have no rate.
+        if (fields.size() < 5 || fields[1] != "all") {
+            continue;
+        }
+
+        try {
+            baseline.operationsPerSecond[fields[0]] = std::stod(fields[4]);
+        }
+        catch (const std::logic_error&) {
+            throw std::runtime_error{
+                "Invalid operations per second in report line \"" + line
+                + "\""};
+        }
+    }
+
+    if (!headerSeen) {
+        throw std::runtime_error{"The baseline report is empty"};
+    }
+
+    return baseline;
+}
+
+BenchmarkReport::Environment BenchmarkReport::currentEnvironment()
+{
+    Environment environment{};
+    environment.timestamp = fmt::format(
+        "{:%Y-%m-%dT%H:%M:%SZ}",
+        std::chrono::floor<std::chrono::seconds>(
+            std::chrono::system_clock::now()));
+    environment.sqliteVersion       = sqlite3_libversion();
+    environment.sqliteSourceId      = sqlite3_sourceid();
+    environment.sqliteBuildProfile  = sqliteBuildProfile();
+    environment.sqliteThreadsafe    = sqlite3_threadsafe();
+    environment.hardwareConcurrency = std::thread::hardware_concurrency();
+#if defined(__clang__)
+    environment.compiler = fmt::format("clang {}", __clang_version__);
+#elif defined(__GNUC__)
+    environment.compiler = fmt::format("gcc {}", __VERSION__);
+#elif defined(_MSC_VER)
+    environment.compiler = fmt::format("msvc {}", _MSC_FULL_VER);
+#else
+    environment.compiler = "unknown";
+#endif
+#if defined(_WIN32)
+    environment.operatingSystem = "windows";
+#elif defined(__APPLE__)
+    environment.operatingSystem = "macos";
+#elif defined(__linux__)
+    environment.operatingSystem = "linux";
+#else
+    environment.operatingSystem = "unknown";
+#endif
+#ifdef NDEBUG
+    environment.assertionsEnabled = false;
+#else
+    environment.assertionsEnabled = true;
+#endif
+    return environment;
+}
+} // namespace sqlite
@@ -0,0 +1,215 @@
+#include <stdexcept>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "columnar_result.hpp"
+
+namespace sqlite {
+static ColumnarResult::ColumnType columnTypeOf(int sqliteType)
+{
+    switch (sqliteType) {
+    case SQLITE_INTEGER:
+        return ColumnarResult::ColumnType::Integer;
+    case SQLITE_FLOAT:
+        return ColumnarResult::ColumnType::Real;
+    case SQLITE_TEXT:
+        return ColumnarResult::ColumnType::Text;
+    case SQLITE_BLOB:
+        return ColumnarResult::ColumnType::Blob;
+    }
+
+    return ColumnarResult::ColumnType::Null;
+}
+
+ColumnarResult::Column::Column(std::string name)
+    : m_name{std::move(name)}
+    , m_type{ColumnType::Null}
+    , m_size{0}
+    , m_validity{}
+    , m_integers{}
+    , m_reals{}
+    , m_offsets{0}
+    , m_bytes{}
+{
+}
+
+const std::string& ColumnarResult::Column::name() const
+{
+    return m_name;
+}
+
+ColumnarResult::ColumnType ColumnarResult::Column::type() const
+{
+    return m_type;
+}
+
+std::size_t ColumnarResult::Column::size() const
+{
+    return m_size;
+}
+
+bool ColumnarResult::Column::isValid(std::size_t row) const
+{
+    checkRow(row);
+    return ((m_validity[row / 64] >> (row % 64)) & 1U) != 0;
+}
+
+std::span<const std::uint64_t> ColumnarResult::Column::validityBitmap() const
+{
+    return m_validity;
+}
+
+std::span<const sqlite3_int64> ColumnarResult::Column::integers() const
+{
+    return m_integers;
+}
+
+std::span<const double> ColumnarResult::Column::reals() const
+{
+    return m_reals;
+}
+
+std::span<const std::size_t> ColumnarResult::Column::offsets() const
+{
+    return m_offsets;
+}
+
+std::span<const std::byte> ColumnarResult::Column::bytes() const
+{
+    return m_bytes;
+}
+
+std::string_view ColumnarResult::Column::text(std::size_t row) const
+{
+    const std::span<const std::byte> bytes{blob(row)};
+    return std::string_view{
+        reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+}
+
+std::span<const std::byte> ColumnarResult::Column::blob(std::size_t row) const
+{
+    checkRow(row);
+
+    if (m_type != ColumnType::Text && m_type != ColumnType::Blob) {
+        throw std::logic_error{fmt::format(
+            "Column \"{}\" holds no text or blob values", m_name)};
+    }
+
+    return std::span<const std::byte>{m_bytes}.subspan(
+        m_offsets[row], m_offsets[row + 1] - m_offsets[row]);
+}
+
+void ColumnarResult::Column::checkRow(std::size_t row) const
+{
+    if (row >= m_size) {
+        throw std::out_of_range{fmt::format(
+            "Row {} is out of range, column \"{}\" has {} rows",
+            row,
+            m_name,
+            m_size)};
+    }
+}
+
+void ColumnarResult::Column::append(const Row& row, int column)
+{
+    const int         sqliteType{row.columnType(column)};
+    const std::size_t bit{m_size % 64};
+
+    if (bit == 0) {
+        m_validity.push_back(0);
+    }
+
+    if (sqliteType != SQLITE_NULL) {
+        if (m_type == ColumnType::Null) {
+            setType(columnTypeOf(sqliteType));
+        }
+
+        m_validity.back() |= std::uint64_t{1} << bit;
+    }
+
+    const bool isNull{sqliteType == SQLITE_NULL};
+
+    switch (m_type) {
+    case ColumnType::Null:
+        break;
+    case ColumnType::Integer:
+        m_integers.push_back(isNull ? 0 : row.int64(column));
+        break;
+    case ColumnType::Real:
+        m_reals.push_back(isNull ? 0.0 : row.real(column));
+        break;
+    case ColumnType::Text:
+        appendBytes(
+            isNull ? std::span<const std::byte>{}
+                   : std::as_bytes(std::span{row.textView(column)}));
+        break;
+    case ColumnType::Blob:
+        appendBytes(isNull ? std::span<const std::byte>{} : row.blob(column));
+        break;
+    }
+
+    ++m_size;
+}
+
+void ColumnarResult::Column::setType(ColumnType type)
+{
+    // Fill in the NULLs that preceded the first value.
+    m_type = type;
+
+    switch (m_type) {
+    case ColumnType::Null:
+        break;
+    case ColumnType::Integer:
+        m_integers.assign(m_size, 0);
+        break;
+    case ColumnType::Real:
+        m_reals.assign(m_size, 0.0);
+        break;
+    case ColumnType::Text:
+    case ColumnType::Blob:
+        m_offsets.assign(m_size + 1, 0);
+        break;
+    }
+}
+
+void ColumnarResult::Column::appendBytes(std::span<const std::byte> bytes)
+{
+    m_bytes.insert(m_bytes.end(), bytes.begin(), bytes.end());
+    m_offsets.push_back(m_bytes.size());
+}
+
+ColumnarResult::ColumnarResult(const Row& row) : m_rowCount{0}, m_columns{}
+{
+    const int columns{row.columnCount()};
+    m_columns.reserve(static_cast<std::size_t>(columns));
+
+    for (int i{0}; i < columns; ++i) {
+        m_columns.push_back(Column{row.columnName(i)});
+    }
+}
+
+void ColumnarResult::append(const Row& row)
+{
+    for (std::size_t i{0}; i < m_columns.size(); ++i) {
+        m_columns[i].append(row, static_cast<int>(i));
+    }
+
+    ++m_rowCount;
+}
+
+std::size_t ColumnarResult::rowCount() const
+{
+    return m_rowCount;
+}
+
+std::size_t ColumnarResult::columnCount() const
+{
+    return m_columns.size();
+}
+
+const ColumnarResult::Column& ColumnarResult::column(std::size_t index) const
+{
+    return m_columns[index];
+}
+} // namespace sqlite
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "connection_pool.hpp"
+
+namespace sqlite {
+ConnectionPool::Handle::Handle(ConnectionPool* pool, std::size_t slotIndex)
+    : m_pool{pool}, m_slotIndex{slotIndex}
+{
+}
+
+ConnectionPool::Handle::Handle(Handle&& other) noexcept
+    : m_pool{other.m_pool}, m_slotIndex{other.m_slotIndex}
+{
+    other.m_pool = nullptr;
+}
+
+ConnectionPool::Handle& ConnectionPool::Handle::operator=(
+    Handle&& other) noexcept
+{
+    std::swap(m_pool, other.m_pool);
+    std::swap(m_slotIndex, other.m_slotIndex);
+    return *this;
+}
+
+ConnectionPool::Handle::~Handle()
+{
+    if (m_pool == nullptr) {
+        return;
+    }
+
+    m_pool->checkin(m_slotIndex);
+}
+
+DatabaseConnection& ConnectionPool::Handle::operator*() const
+{
+    return m_pool->m_slots[m_slotIndex].connection;
+}
+
+DatabaseConnection* ConnectionPool::Handle::operator->() const
+{
+    return &**this;
+}
+
+ConnectionPool::ConnectionPool(
+    const char* filename,
+    int         flags,
+    const char* vfsModuleName,
+    std::size_t size)
+    : m_mutex{}, m_connectionReturned{}, m_slots{}, m_idleSlots{}
+{
+    m_slots.reserve(size);
+    m_idleSlots.reserve(size);
+
+    for (std::size_t i{0}; i < size; ++i) {
+        m_slots.push_back(Slot{
+            DatabaseConnection{filename, flags, vfsModuleName},
+            std::thread::id{}});
+        m_idleSlots.push_back(i);
+    }
+}
+
+ConnectionPool::Handle ConnectionPool::checkout()
+{
+    const std::thread::id        self{std::this_thread::get_id()};
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_connectionReturned.wait(lock, [this] { return !m_idleSlots.empty(); });
+
+    // Prefer the connection this thread used last, otherwise take the most
+    // recently returned one.
+    std::vector<std::size_t>::iterator it{std::find_if(
+        m_idleSlots.begin(), m_idleSlots.end(), [this, self](std::size_t i) {
+            return m_slots[i].lastOwner == self;
+        })};
+
+    if (it == m_idleSlots.end()) {
+        it = std::prev(m_idleSlots.end());
+    }
+
+    const std::size_t slotIndex{*it};
+    m_idleSlots.erase(it);
+    m_slots[slotIndex].lastOwner = self;
+    return Handle{this, slotIndex};
+}
+
+std::size_t ConnectionPool::size() const
+{
+    return m_slots.size();
+}
+
+std::size_t ConnectionPool::idleCount() const
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    return m_idleSlots.size();
+}
+
+void ConnectionPool::checkin(std::size_t slotIndex)
+{
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        m_idleSlots.push_back(slotIndex);
+    }
+
+    m_connectionReturned.notify_one();
+}
+} // namespace sqlite
@@ -5,14 +5,22 @@
 
 #include "as_string.hpp"
 #include "database_connection.hpp"
+#include "statement_profiler.hpp"
 #include "throw.hpp"
 
 namespace sqlite {
+namespace {
+constexpr int busyTimeoutMilliseconds{5000};
+} // anonymous namespace
+
 DatabaseConnection::DatabaseConnection(
     const char* filename,
     int         flags,
-    const char* vfsModuleName)
+    const char* vfsModuleName,
+    std::size_t statementCacheCapacity)
     : m_connection{nullptr}
+    , m_statementCache{std::make_unique<StatementCache>(statementCacheCapacity)}
+    , m_transactionDepth{0}
 {
     const int resultCode{sqlite3_open_v2(
         /* filename */ filename,
@@ -28,6 +36,13 @@ DatabaseConnection::DatabaseConnection(
             sqlite3_errmsg(m_connection));
     }
 
+    // Before anything runs, so that the PRAGMA below is profiled as well.
+    enableStatementProfiling(m_connection);
+
+    // Connections opened concurrently race for the lock needed to switch the
+    // journal mode, so wait for it rather than failing with SQLITE_BUSY.
+    sqlite3_busy_timeout(m_connection, busyTimeoutMilliseconds);
+
     // Enable write ahead logging
     sqlite::PreparedStatement stmt{
         prepareStatement("PRAGMA journal_mode=WAL;")};
@@ -36,6 +51,8 @@ DatabaseConnection::DatabaseConnection(
 
 DatabaseConnection::DatabaseConnection(DatabaseConnection&& other) noexcept
     : m_connection{other.m_connection}
+    , m_statementCache{std::move(other.m_statementCache)}
+    , m_transactionDepth{other.m_transactionDepth}
 {
     other.m_connection = nullptr;
 }
@@ -44,6 +61,8 @@ DatabaseConnection& DatabaseConnection::operator=(
     DatabaseConnection&& other) noexcept
 {
     std::swap(m_connection, other.m_connection);
+    std::swap(m_statementCache, other.m_statementCache);
+    std::swap(m_transactionDepth, other.m_transactionDepth);
     return *this;
 }
 
@@ -53,6 +72,9 @@ DatabaseConnection::~DatabaseConnection()
         return;
     }
 
+    // Finalize the cached statements before closing the connection.
+    m_statementCache.reset();
+
     const int resultCode{sqlite3_close_v2(m_connection)};
 
     if (resultCode != SQLITE_OK) {
@@ -84,6 +106,86 @@ PreparedStatement DatabaseConnection::prepareStatement(const char* sqlStatement)
             sqlStatement);
     }
 
-    return PreparedStatement{m_connection, statement, sqlStatement};
+    // sqlite3_sql stays valid for as long as the statement, which matters
+    // for statements kept in the statement cache.
+    return PreparedStatement{m_connection, statement, sqlite3_sql(statement)};
+}
+
+StatementCache::Handle DatabaseConnection::cachedStatement(
+    const char* sqlStatement)
+{
+    return m_statementCache->acquire(*this, sqlStatement);
+}
+
+StatementCache::Statistics DatabaseConnection::statementCacheStatistics() const
+{
+    return m_statementCache->statistics();
+}
+
+DatabaseConnection::Stats DatabaseConnection::Stats::operator-(
+    const Stats& before) const
+{
+    return Stats{
+        cacheHits - before.cacheHits,
+        cacheMisses - before.cacheMisses,
+        cacheWrites - before.cacheWrites,
+        cacheSpills - before.cacheSpills,
+        cacheBytes - before.cacheBytes,
+        lookasideSlotsUsed - before.lookasideSlotsUsed,
+        lookasideHits - before.lookasideHits,
+        lookasideMissesSize - before.lookasideMissesSize,
+        lookasideMissesFull - before.lookasideMissesFull,
+        schemaBytes - before.schemaBytes,
+        statementBytes - before.statementBytes};
+}
+
+DatabaseConnection::Stats DatabaseConnection::stats() const
+{
+    // The lookaside hit and miss counts are only reported as highwater.
+    return Stats{
+        status(SQLITE_DBSTATUS_CACHE_HIT, false),
+        status(SQLITE_DBSTATUS_CACHE_MISS, false),
+        status(SQLITE_DBSTATUS_CACHE_WRITE, false),
+        status(SQLITE_DBSTATUS_CACHE_SPILL, false),
+        status(SQLITE_DBSTATUS_CACHE_USED, false),
+        status(SQLITE_DBSTATUS_LOOKASIDE_USED, false),
+        status(SQLITE_DBSTATUS_LOOKASIDE_HIT, true),
+        status(SQLITE_DBSTATUS_LOOKASIDE_MISS_SIZE, true),
+        status(SQLITE_DBSTATUS_LOOKASIDE_MISS_FULL, true),
+        status(SQLITE_DBSTATUS_SCHEMA_USED, false),
+        status(SQLITE_DBSTATUS_STMT_USED, false)};
+}
+
+void DatabaseConnection::execute(const char* sqlStatement)
+{
+    const StatementCache::Handle statement{cachedStatement(sqlStatement)};
+    statement->run();
+}
+
+Transaction DatabaseConnection::transaction(Transaction::Mode mode)
+{
+    return Transaction{*this, mode};
+}
+
+std::int64_t DatabaseConnection::status(int operation, bool highwater) const
+{
+    int       current{0};
+    int       highwaterValue{0};
+    const int resultCode{sqlite3_db_status(
+        /* db */ m_connection,
+        /* op */ operation,
+        /* pCur */ &current,
+        /* pHiwtr */ &highwaterValue,
+        /* resetFlg */ 0)};
+
+    if (resultCode != SQLITE_OK) {
+        SQLITE_THROW(
+            Exception,
+            resultCode,
+            "sqlite3_db_status failed for operation {}",
+            operation);
+    }
+
+    return highwater ? highwaterValue : current;
 }
 } // namespace sqlite
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include "latency_histogram.hpp"
+
+namespace sqlite {
+namespace {
+// The histogram has a single writer, so a relaxed load and store is enough
+// and avoids the locked read-modify-write of fetch_add.
+void add(std::atomic<std::uint64_t>& counter, std::uint64_t value) noexcept
+{
+    counter.store(
+        counter.load(std::memory_order_relaxed) + value,
+        std::memory_order_relaxed);
+}
+} // anonymous namespace
+
+LatencyHistogram::LatencyHistogram()
+    : m_buckets{}, m_count{0}, m_totalNanoseconds{0}, m_maxNanoseconds{0}
+{
+}
+
+LatencyHistogram::LatencyHistogram(const LatencyHistogram& other)
+    : LatencyHistogram{}
+{
+    merge(other);
+}
+
+LatencyHistogram& LatencyHistogram::operator=(const LatencyHistogram& other)
+{
+    if (this != &other) {
+        reset();
+        merge(other);
+    }
+
+    return *this;
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds latency) noexcept
+{
+    const std::uint64_t nanoseconds{static_cast<std::uint64_t>(
+        std::max(latency.count(), std::chrono::nanoseconds::rep{0}))};
+    add(m_buckets[bucketIndex(nanoseconds)], 1);
+    add(m_count, 1);
+    add(m_totalNanoseconds, nanoseconds);
+
+    if (nanoseconds > m_maxNanoseconds.load(std::memory_order_relaxed)) {
+        m_maxNanoseconds.store(nanoseconds, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) noexcept
+{
+    for (std::size_t i{0}; i < bucketCount; ++i) {
+        add(m_buckets[i], other.m_buckets[i].load(std::memory_order_relaxed));
+    }
+
+    add(m_count, other.m_count.load(std::memory_order_relaxed));
+    add(m_totalNanoseconds,
+        other.m_totalNanoseconds.load(std::memory_order_relaxed));
+    m_maxNanoseconds.store(
+        std::max(
+            m_maxNanoseconds.load(std::memory_order_relaxed),
+            other.m_maxNanoseconds.load(std::memory_order_relaxed)),
+        std::memory_order_relaxed);
+}
+
+void LatencyHistogram::reset() noexcept
+{
+    for (std::atomic<std::uint64_t>& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+
+    m_count.store(0, std::memory_order_relaxed);
+    m_totalNanoseconds.store(0, std::memory_order_relaxed);
+    m_maxNanoseconds.store(0, std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::count() const noexcept
+{
+    return m_count.load(std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds LatencyHistogram::total() const noexcept
+{
+    return std::chrono::nanoseconds{static_cast<std::int64_t>(
+        m_totalNanoseconds.load(std::memory_order_relaxed))};
+}
+
+std::chrono::nanoseconds LatencyHistogram::max() const noexcept
+{
+    return std::chrono::nanoseconds{static_cast<std::int64_t>(
+        m_maxNanoseconds.load(std::memory_order_relaxed))};
+}
+
+std::chrono::nanoseconds LatencyHistogram::percentile(
+    double percentile) const noexcept
+{
+    std::uint64_t bucketTotal{0};
+
+    for (const std::atomic<std::uint64_t>& bucket : m_buckets) {
+        bucketTotal += bucket.load(std::memory_order_relaxed);
+    }
+
+    if (bucketTotal == 0) {
+        return std::chrono::nanoseconds{0};
+    }
+
+    const double        fraction{std::clamp(percentile, 0.0, 100.0) / 100.0};
+    const std::uint64_t rank{std::max(
+        std::uint64_t{1},
+        static_cast<std::uint64_t>(
+            std::ceil(fraction * static_cast<double>(bucketTotal))))};
+    const std::uint64_t maxNanoseconds{
+        m_maxNanoseconds.load(std::memory_order_relaxed)};
+    std::uint64_t seen{0};
+
+    for (std::size_t i{0}; i < bucketCount; ++i) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+
+        if (seen >= rank) {
+            return std::chrono::nanoseconds{static_cast<std::int64_t>(
+                std::min(bucketUpperBound(i), maxNanoseconds))};
+        }
+    }
+
+    return max();
+}
+
+std::size_t LatencyHistogram::bucketIndex(std::uint64_t nanoseconds) noexcept
+{
+    if (nanoseconds < 2 * subBucketCount) {
+        return static_cast<std::size_t>(nanoseconds);
+    }
+
+    // Keeps the subBucketBits + 1 most significant bits: the top one
+    // selects the power of two, the others the sub-bucket.
+    const int shift{std::min(
+        static_cast<int>(std::bit_width(nanoseconds)) - (subBucketBits + 1),
+        maxShift)};
+    const std::uint64_t subBucket{
+        std::min(nanoseconds >> shift, 2 * subBucketCount - 1)};
+    return 2 * subBucketCount
+           + static_cast<std::size_t>(shift - 1) * subBucketCount
+           + static_cast<std::size_t>(subBucket - subBucketCount);
+}
+
+std::uint64_t LatencyHistogram::bucketUpperBound(std::size_t index) noexcept
+{
+    if (index < 2 * subBucketCount) {
+        return index;
+    }
+
+    const std::size_t   offset{index - 2 * subBucketCount};
+    const int           shift{static_cast<int>(offset / subBucketCount) + 1};
+    const std::uint64_t subBucket{offset % subBucketCount + subBucketCount};
+    return ((subBucket + 1) << shift) - 1;
+}
+} // namespace sqlite
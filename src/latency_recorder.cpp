@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "latency_recorder.hpp"
+
+namespace sqlite {
+namespace {
+struct SqlHash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view sql) const noexcept
+    {
+        return std::hash<std::string_view>{}(sql);
+    }
+};
+
+using HistogramMap = std::unordered_map<
+    std::string,
+    std::unique_ptr<LatencyHistogram>,
+    SqlHash,
+    std::equal_to<>>;
+
+void mergeHistograms(HistogramMap& target, const HistogramMap& source)
+{
+    for (const auto& [sql, histogram] : source) {
+        std::unique_ptr<LatencyHistogram>& merged{target[sql]};
+
+        if (merged == nullptr) {
+            merged = std::make_unique<LatencyHistogram>();
+        }
+
+        merged->merge(*histogram);
+    }
+}
+
+class ThreadLatencies;
+
+// Knows the histograms of every live thread and keeps the ones of threads
+// that have exited. Locked before the mutex of a ThreadLatencies.
+struct LatencyRegistry {
+    std::mutex                    mutex;
+    std::vector<ThreadLatencies*> threads;
+    HistogramMap                  retired;
+};
+
+LatencyRegistry& latencyRegistry()
+{
+    static LatencyRegistry registry{};
+    return registry;
+}
+
+// The histograms of one thread. Only the owning thread records into them;
+// m_mutex keeps other threads from reading the map while a new SQL text is
+// inserted.
+class ThreadLatencies {
+public:
+    ThreadLatencies() : m_mutex{}, m_histograms{}
+    {
+        LatencyRegistry&                  registry{latencyRegistry()};
+        const std::lock_guard<std::mutex> lock{registry.mutex};
+        registry.threads.push_back(this);
+    }
+
+    ThreadLatencies(const ThreadLatencies&) = delete;
+
+    ThreadLatencies& operator=(const ThreadLatencies&) = delete;
+
+    ~ThreadLatencies()
+    {
+        LatencyRegistry&                  registry{latencyRegistry()};
+        const std::lock_guard<std::mutex> lock{registry.mutex};
+        mergeInto(registry.retired);
+        std::erase(registry.threads, this);
+    }
+
+    LatencyHistogram& histogram(std::string_view sql)
+    {
+        const HistogramMap::iterator it{m_histograms.find(sql)};
+
+        if (it != m_histograms.end()) {
+            return *it->second;
+        }
+
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        return *m_histograms
+                    .emplace(
+                        std::string{sql}, std::make_unique<LatencyHistogram>())
+                    .first->second;
+    }
+
+    void mergeInto(HistogramMap& target) const
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        mergeHistograms(target, m_histograms);
+    }
+
+    void reset()
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+
+        for (const auto& [sql, histogram] : m_histograms) {
+            histogram->reset();
+        }
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    HistogramMap       m_histograms;
+};
+} // anonymous namespace
+
+void recordLatency(std::string_view sql, std::chrono::nanoseconds latency)
+{
+    thread_local ThreadLatencies threadLatencies{};
+    threadLatencies.histogram(sql).record(latency);
+}
+
+std::vector<StatementLatency> latencySnapshot()
+{
+    HistogramMap merged{};
+
+    {
+        LatencyRegistry&                  registry{latencyRegistry()};
+        const std::lock_guard<std::mutex> lock{registry.mutex};
+        mergeHistograms(merged, registry.retired);
+
+        for (const ThreadLatencies* threadLatencies : registry.threads) {
+            threadLatencies->mergeInto(merged);
+        }
+    }
+
+    std::vector<StatementLatency> snapshot{};
+    snapshot.reserve(merged.size());
+
+    for (const auto& [sql, histogram] : merged) {
+        snapshot.push_back(StatementLatency{sql, *histogram});
+    }
+
+    std::sort(
+        snapshot.begin(),
+        snapshot.end(),
+        [](const StatementLatency& lhs, const StatementLatency& rhs) {
+            return lhs.sql < rhs.sql;
+        });
+    return snapshot;
+}
+
+void resetLatencies()
+{
+    LatencyRegistry&                  registry{latencyRegistry()};
+    const std::lock_guard<std::mutex> lock{registry.mutex};
+    registry.retired.clear();
+
+    for (ThreadLatencies* threadLatencies : registry.threads) {
+        threadLatencies->reset();
+    }
+}
+} // namespace sqlite
@@ -1,90 +1,1384 @@
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <cstdio>
+#include <cstdlib>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <future>
 #include <iostream>
+#include <latch>
 #include <memory>
+#include <memory_resource>
+#include <optional>
+#include <ranges>
 #include <sstream>
 #include <stdexcept>
 #include <thread>
+#include <tuple>
 
 #include <gsl/util>
 
 #include <pl/timer.hpp>
 
+#include "allocation_counter.hpp"
+#include "async_executor.hpp"
+#include "benchmark_options.hpp"
+#include "benchmark_report.hpp"
+#include "bulk_insert.hpp"
+#include "connection_pool.hpp"
 #include "database_connection.hpp"
+#include "detached_task.hpp"
+#include "latency_recorder.hpp"
 #include "load_emails.hpp"
-
-#define SQLITE_DATABASE_FILE_NAME "test_database.db"
-#define SQLITE_VFS nullptr
+#include "process_stats.hpp"
+#include "scaling_curve.hpp"
+#include "statement.hpp"
+#include "statement_costs.hpp"
+#include "statement_profiler.hpp"
+#include "threading_mode.hpp"
 
 namespace sqlite {
 namespace {
-constexpr int         repeatCount{500};
-constexpr std::size_t threadCount{10};
-
-sqlite::DatabaseConnection* getConnection()
-{
-#if USE_MUTEX
-    static sqlite::DatabaseConnection connection{
-        /* filename */ SQLITE_DATABASE_FILE_NAME,
-        /* flags */ SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE
-            | SQLITE_OPEN_FULLMUTEX,
-        /* vfsModuleName */ SQLITE_VFS};
-    return &connection;
-#else
-    sqlite::DatabaseConnection* const connection{new sqlite::DatabaseConnection{
-        /* filename */ SQLITE_DATABASE_FILE_NAME,
-        /* flags */ SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE
-            | SQLITE_OPEN_NOMUTEX,
-        /* vfsModuleName */ SQLITE_VFS}};
-    return connection;
-#endif
+constexpr int         workerRounds{20};
+constexpr std::size_t insertBatchSize{100};
+constexpr std::size_t arenaBufferSize{1024 * 1024};
+
+constexpr const char* selectCustomersQuery{
+    "SELECT customer_id, first_name, last_name, email, phone, "
+    "address FROM "
+    "customer;"};
+constexpr const char* selectCustomerByIdQuery{
+    "SELECT customer_id, first_name, last_name, email, phone, "
+    "address FROM "
+    "customer WHERE customer_id = ?;"};
+constexpr const char* insertCustomerQuery{
+    "INSERT INTO customer (first_name, last_name, email, phone, "
+    "address) "
+    "VALUES (?, ?, ?, ?, ?);"};
+constexpr const char* heavyCustomersQuery{
+    "SELECT count(*) FROM customer AS a JOIN customer AS b ON a.email < "
+    "b.email;"};
+constexpr const char* selectCustomerByEmailQuery{
+    "SELECT customer_id FROM customer WHERE email = :email;"};
+
+constexpr int connectionFlags{
+    SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX};
+
+// How the connections of a threading mode matrix entry are opened and
+// shared between the workers.
+struct ConnectionStrategy {
+    const char* name;
+    int         mutexFlag;
+    bool        sharedConnection;
+};
+
+constexpr ConnectionStrategy connectionStrategies[]{
+    {"NOMUTEX, connection per thread", SQLITE_OPEN_NOMUTEX, false},
+    {"FULLMUTEX, shared connection", SQLITE_OPEN_FULLMUTEX, true},
+    {"FULLMUTEX, connection per thread", SQLITE_OPEN_FULLMUTEX, false},
+    {"default flags, connection per thread", 0, false}};
+
+// Human readable progress; stderr when the report is written to stdout.
+std::FILE* progressOutput{stdout};
+
+template <typename Function>
+void reportExceptions(Function function)
+{
+    try {
+        function();
+    }
+    catch (const sqlite::Exception& ex) {
+        std::cerr << "std::thread: caught " << ex << '\n';
+    }
+    catch (const std::runtime_error& ex) {
+        std::cerr << "std::thread: caught runtime_error: " << ex.what()
+                  << '\n';
+    }
 }
 
-class ConnectionCloser {
-public:
-    explicit ConnectionCloser(sqlite::DatabaseConnection* conn) : m_conn{conn}
-    {
+struct Customer {
+    using Columns = std::tuple<
+        sqlite3_int64,
+        std::string,
+        std::string,
+        std::string,
+        std::string,
+        std::string>;
+
+    sqlite3_int64 customerId;
+    std::string   firstName;
+    std::string   lastName;
+    std::string   email;
+    std::string   phone;
+    std::string   address;
+};
+
+template <typename Function>
+double timeInMilliseconds(Function function)
+{
+    pl::timer timer{};
+    function();
+    return std::chrono::duration<double, std::milli>{timer.elapsed_time()}
+        .count();
+}
+
+double queriesPerSecond(std::size_t queryCount, double milliseconds)
+{
+    return milliseconds > 0.0
+               ? static_cast<double>(queryCount) * 1000.0 / milliseconds
+               : 0.0;
+}
+
+std::size_t readerTaskCount(const sqlite::BenchmarkOptions& options)
+{
+    return options.threadCount * options.iterationCount;
+}
+
+void addResult(
+    sqlite::BenchmarkReport& report,
+    std::string              name,
+    std::size_t              operationCount,
+    double                   milliseconds,
+    std::optional<double>    allocationsPerOperation = std::nullopt,
+    std::vector<sqlite::BenchmarkReport::WorkerTotals> workers = {})
+{
+    report.add(sqlite::BenchmarkReport::Result{
+        std::move(name),
+        operationCount,
+        milliseconds,
+        allocationsPerOperation,
+        std::move(workers),
+        std::nullopt});
+}
+
+// Runs function and prints how the process-wide SQLite status and, unless
+// connection is null, the status of connection changed meanwhile.
+template <typename Function>
+void printStatusDeltas(
+    const char*                       run,
+    const sqlite::DatabaseConnection* connection,
+    Function                          function)
+{
+    const sqlite::ProcessStats processBefore{sqlite::processStats()};
+    const std::optional<sqlite::DatabaseConnection::Stats> connectionBefore{
+        connection != nullptr ? std::make_optional(connection->stats())
+                              : std::nullopt};
+    function();
+    const sqlite::ProcessStats process{
+        sqlite::processStats() - processBefore};
+    std::fprintf(
+        progressOutput,
+        "  SQLite status after %s: memory %+lld bytes (highwater %lld), "
+        "%+lld allocations, page cache %+lld pages (overflow %+lld bytes)\n",
+        run,
+        static_cast<long long>(process.memoryBytes),
+        static_cast<long long>(process.memoryHighwaterBytes),
+        static_cast<long long>(process.outstandingAllocations),
+        static_cast<long long>(process.pageCachePages),
+        static_cast<long long>(process.pageCacheOverflowBytes));
+
+    if (connection == nullptr || !connectionBefore.has_value()) {
+        return;
+    }
+
+    const sqlite::DatabaseConnection::Stats stats{
+        connection->stats() - *connectionBefore};
+    std::fprintf(
+        progressOutput,
+        "    connection: cache %lld hits, %lld misses, %lld writes, %lld "
+        "spills, %+lld bytes; lookaside %+lld slots, %lld hits, %lld size "
+        "misses, %lld full misses; schema %+lld bytes, statements %+lld "
+        "bytes\n",
+        static_cast<long long>(stats.cacheHits),
+        static_cast<long long>(stats.cacheMisses),
+        static_cast<long long>(stats.cacheWrites),
+        static_cast<long long>(stats.cacheSpills),
+        static_cast<long long>(stats.cacheBytes),
+        static_cast<long long>(stats.lookasideSlotsUsed),
+        static_cast<long long>(stats.lookasideHits),
+        static_cast<long long>(stats.lookasideMissesSize),
+        static_cast<long long>(stats.lookasideMissesFull),
+        static_cast<long long>(stats.schemaBytes),
+        static_cast<long long>(stats.statementBytes));
+}
+
+// Returns the e-mails of the customers created.
+std::vector<std::string> createCustomers(
+    const sqlite::BenchmarkOptions& options,
+    sqlite::BenchmarkReport&        report,
+    sqlite::DatabaseConnection&     db,
+    std::vector<std::string>&       emails)
+{
+    sqlite::PreparedStatement createTableStatement{db.prepareStatement(R"(
+    CREATE TABLE customer (
+      customer_id INTEGER PRIMARY KEY,
+      first_name TEXT NOT NULL,
+      last_name TEXT NOT NULL,
+      email TEXT NOT NULL,
+      phone TEXT,
+      address TEXT
+    );)")};
+    createTableStatement.run();
+
+    const std::size_t rowCount{options.rowCount};
+
+    if (emails.size() < rowCount) {
+        throw std::runtime_error{
+            "--rows exceeds the " + std::to_string(emails.size())
+            + " e-mails available"};
+    }
+
+    const double insertTime{timeInMilliseconds([&db, &emails, rowCount] {
+        sqlite::bulkInsert(
+            db,
+            insertCustomerQuery,
+            emails | std::views::reverse | std::views::take(rowCount),
+            insertBatchSize,
+            // The e-mails outlive the statement's bindings, which are
+            // cleared when it goes back to the statement cache.
+            [](sqlite::PreparedStatement& statement, const std::string& email) {
+                statement.bindAll(
+                    sqlite::borrow("John"),
+                    sqlite::borrow("Doe"),
+                    sqlite::borrow(email),
+                    sqlite::borrow("+12345678"),
+                    sqlite::borrow("123 Main St"));
+            });
+    })};
+    std::vector<std::string> customerEmails(
+        emails.end() - static_cast<std::ptrdiff_t>(rowCount), emails.end());
+    emails.resize(emails.size() - rowCount);
+    std::fprintf(
+        progressOutput,
+        "Inserting %zu customers in batches of %zu took %.1f milliseconds.\n",
+        rowCount,
+        insertBatchSize,
+        insertTime);
+    addResult(report, "insert customers", rowCount, insertTime);
+    return customerEmails;
+}
+
+// Looks every customer up by e-mail, binding the e-mail by position and by
+// parameter name.
+void benchmarkEmailLookup(
+    sqlite::BenchmarkReport&        report,
+    sqlite::DatabaseConnection&     db,
+    const std::vector<std::string>& customerEmails)
+{
+    using namespace sqlite::literals;
+    sqlite::PreparedStatement statement{
+        db.prepareStatement(selectCustomerByEmailQuery)};
+    const auto lookUpCustomers{[&statement, &customerEmails](auto bindEmail) {
+        return timeInMilliseconds([&statement, &customerEmails, &bindEmail] {
+            for (const std::string& email : customerEmails) {
+                bindEmail(email);
+                statement.forEach([](const sqlite::Row&) {});
+                statement.reset();
+            }
+        });
+    }};
+    const double positionalTime{
+        lookUpCustomers([&statement](const std::string& email) {
+            statement.bind(1, sqlite::borrow(email));
+        })};
+    const double namedTime{
+        lookUpCustomers([&statement](const std::string& email) {
+            statement.bind(":email"_param, sqlite::borrow(email));
+        })};
+    std::fprintf(
+        progressOutput,
+        "Looking up %zu customers by e-mail took %.1f milliseconds binding "
+        "by position and %.1f milliseconds binding by name.\n",
+        customerEmails.size(),
+        positionalTime,
+        namedTime);
+    addResult(
+        report,
+        "e-mail lookup, positional binding",
+        customerEmails.size(),
+        positionalTime);
+    addResult(
+        report,
+        "e-mail lookup, named binding",
+        customerEmails.size(),
+        namedTime);
+}
+
+void readCustomers(sqlite::DatabaseConnection& databaseConnection)
+{
+    const sqlite::StatementCache::Handle statement{
+        databaseConnection.cachedStatement(selectCustomersQuery)};
+    const std::vector<std::vector<sqlite::PreparedStatement::Variant>>
+        results{statement->run()};
+    (void)results;
+}
+
+enum class ReaderMode { CollectRows, ForEachRow, Profiled };
+
+const char* readerModeName(ReaderMode mode)
+{
+    switch (mode) {
+    case ReaderMode::CollectRows:
+        return "run()";
+    case ReaderMode::ForEachRow:
+        return "forEach()";
+    case ReaderMode::Profiled:
+        return "runProfiled()";
+    }
+
+    return "unknown";
+}
+
+// A query of the reader tasks; customerId is bound to its parameter unless
+// it is 0.
+struct ReaderQuery {
+    const char*   sql;
+    sqlite3_int64 customerId;
+};
+
+// Picks the query of task from the weights of queryMix.
+ReaderQuery mixedQuery(
+    const sqlite::QueryMix& queryMix,
+    std::size_t             task,
+    std::size_t             rowCount)
+{
+    const std::size_t slot{
+        task % (queryMix.scan + queryMix.point + queryMix.join)};
+
+    if (slot < queryMix.scan) {
+        return ReaderQuery{selectCustomersQuery, 0};
+    }
+
+    if (slot < queryMix.scan + queryMix.point) {
+        return ReaderQuery{
+            selectCustomerByIdQuery,
+            static_cast<sqlite3_int64>(task % rowCount) + 1};
+    }
+
+    return ReaderQuery{heavyCustomersQuery, 0};
+}
+
+// Returns the number of rows read.
+std::size_t runReaderQuery(
+    sqlite::DatabaseConnection& databaseConnection,
+    const ReaderQuery&          query,
+    ReaderMode                  mode)
+{
+    const sqlite::StatementCache::Handle statement{
+        databaseConnection.cachedStatement(query.sql)};
+
+    if (query.customerId != 0) {
+        statement->bind(1, query.customerId);
+    }
+
+    switch (mode) {
+    case ReaderMode::CollectRows:
+        return statement->run().size();
+    case ReaderMode::ForEachRow:
+        return statement->forEach([](const sqlite::Row&) {});
+    case ReaderMode::Profiled:
+        return statement->runProfiled().size();
     }
 
-    ~ConnectionCloser()
+    return 0;
+}
+
+struct ExecutorMeasurement {
+    double                                             milliseconds;
+    std::vector<sqlite::BenchmarkReport::WorkerTotals> workers;
+    std::uint64_t                                      rowCount;
+
+    std::uint64_t stolenTaskCount() const
     {
-#if USE_MUTEX
-        // no op
+        std::uint64_t stolenTaskCount{0};
+
+        for (const sqlite::BenchmarkReport::WorkerTotals& worker : workers) {
+            stolenTaskCount += worker.stolenTaskCount;
+        }
+
+        return stolenTaskCount;
+    }
+};
+
+// Times function, which runs its work on executor, and collects what every
+// worker contributed meanwhile.
+template <typename Function>
+ExecutorMeasurement measureOnExecutor(
+    sqlite::AsyncExecutor& executor,
+    Function               function)
+{
+    const std::vector<sqlite::AsyncExecutor::WorkerStatistics> before{
+        executor.workerStatistics()};
+    const double milliseconds{timeInMilliseconds(function)};
+    const std::vector<sqlite::AsyncExecutor::WorkerStatistics> after{
+        executor.workerStatistics()};
+    ExecutorMeasurement measurement{milliseconds, {}, 0};
+
+    for (std::size_t i{0}; i < after.size(); ++i) {
+        measurement.workers.push_back(sqlite::BenchmarkReport::WorkerTotals{
+            after[i].taskCount - before[i].taskCount,
+            after[i].stolenTaskCount - before[i].stolenTaskCount,
+            std::chrono::duration<double, std::milli>{
+                after[i].busyTime - before[i].busyTime}
+                .count()});
+    }
+
+    return measurement;
+}
+
+// Dispatches taskCount single-query tasks, taking the query of task i from
+// queryForTask(i), and waits for all of them. The tasks use
+// sharedConnection if it isn't null and their worker's connection
+// otherwise.
+template <typename QueryForTask>
+ExecutorMeasurement measureReaderTasks(
+    sqlite::AsyncExecutor&      executor,
+    sqlite::DatabaseConnection* sharedConnection,
+    std::size_t                 taskCount,
+    ReaderMode                  mode,
+    QueryForTask                queryForTask)
+{
+    std::atomic<std::uint64_t> rowCount{0};
+    ExecutorMeasurement        measurement{measureOnExecutor(
+        executor,
+        [&executor,
+         sharedConnection,
+         taskCount,
+         mode,
+         &queryForTask,
+         &rowCount] {
+            std::latch done{static_cast<std::ptrdiff_t>(taskCount)};
+
+            for (std::size_t i{0}; i < taskCount; ++i) {
+                executor.dispatch([&done,
+                                   &rowCount,
+                                   sharedConnection,
+                                   mode,
+                                   query = queryForTask(i)](
+                                      sqlite::DatabaseConnection& connection) {
+                    const auto countDown{
+                        gsl::finally([&done] { done.count_down(); })};
+                    rowCount.fetch_add(
+                        runReaderQuery(
+                            sharedConnection != nullptr ? *sharedConnection
+                                                        : connection,
+                            query,
+                            mode),
+                        std::memory_order_relaxed);
+                });
+            }
+
+            done.wait();
+        })};
+    measurement.rowCount = rowCount.load(std::memory_order_relaxed);
+    return measurement;
+}
+
+// Runs the reader query threads * iterations times, one task per query.
+double runReaderTasks(
+    const sqlite::BenchmarkOptions& options,
+    sqlite::BenchmarkReport&        report,
+    sqlite::AsyncExecutor&          executor,
+    ReaderMode                      mode)
+{
+    ExecutorMeasurement measurement{measureReaderTasks(
+        executor,
+        /* sharedConnection */ nullptr,
+        readerTaskCount(options),
+        mode,
+        [](std::size_t) { return ReaderQuery{selectCustomersQuery, 0}; })};
+    std::ostringstream oss{};
+    oss << std::fixed << std::setprecision(1)
+        << "The reader tasks took a total of " << measurement.milliseconds
+        << " milliseconds on " << executor.threadCount() << " workers, "
+        << measurement.stolenTaskCount() << " tasks stolen, rows read with "
+        << readerModeName(mode);
+    std::fprintf(progressOutput, "%s\n", oss.str().c_str());
+    addResult(
+        report,
+        std::string{"reader tasks, "} + readerModeName(mode),
+        readerTaskCount(options),
+        measurement.milliseconds,
+        std::nullopt,
+        std::move(measurement.workers));
+    return measurement.milliseconds;
+}
+
+// Runs the reader tasks with the queries of --query-mix. Heavy joins leave
+// the workers with very uneven queues that stealing has to even out.
+void benchmarkQueryMix(
+    const sqlite::BenchmarkOptions& options,
+    sqlite::BenchmarkReport&        report,
+    sqlite::AsyncExecutor&          executor)
+{
+    ExecutorMeasurement measurement{measureReaderTasks(
+        executor,
+        /* sharedConnection */ nullptr,
+        readerTaskCount(options),
+        ReaderMode::ForEachRow,
+        [&options](std::size_t task) {
+            return mixedQuery(options.queryMix, task, options.rowCount);
+        })};
+    const std::string queryMix{sqlite::toString(options.queryMix)};
+    std::fprintf(
+        progressOutput,
+        "Mixed reader tasks (%s): %.1f milliseconds, %llu tasks stolen.\n",
+        queryMix.c_str(),
+        measurement.milliseconds,
+        static_cast<unsigned long long>(measurement.stolenTaskCount()));
+    addResult(
+        report,
+        "mixed reader tasks, " + queryMix,
+        readerTaskCount(options),
+        measurement.milliseconds,
+        std::nullopt,
+        std::move(measurement.workers));
+}
+
+// Dumps the estimated and the actual rows of every query plan element of
+// the heavy join and the primary key lookup, much like EXPLAIN ANALYZE.
+void printScanStatus([[maybe_unused]] sqlite::DatabaseConnection& db)
+{
+#ifdef SQLITE_ENABLE_STMT_SCANSTATUS
+    for (const char* sql : {heavyCustomersQuery, selectCustomerByIdQuery}) {
+        sqlite::PreparedStatement statement{db.prepareStatement(sql)};
+
+        if (statement.parameterCount() != 0) {
+            statement.bind(1, sqlite3_int64{1});
+        }
+
+        const std::size_t rowCount{
+            statement.forEach([](const sqlite::Row&) {})};
+        (void)rowCount;
+        std::fprintf(
+            progressOutput,
+            "Query plan of \"%s\":\n%s",
+            sql,
+            sqlite::formatScanStatus(statement.scanStatus()).c_str());
+    }
 #else
-        delete m_conn;
+    std::fprintf(
+        progressOutput,
+        "No query plan figures: SQLite was built without "
+        "SQLITE_ENABLE_STMT_SCANSTATUS.\n");
 #endif
+}
+
+double microseconds(std::chrono::nanoseconds duration)
+{
+    return std::chrono::duration<double, std::micro>{duration}.count();
+}
+
+// Runs the mixed reader tasks through runProfiled() and reports the latency
+// percentiles of every statement, merged over the workers.
+void benchmarkLatencies(
+    const sqlite::BenchmarkOptions& options,
+    sqlite::BenchmarkReport&        report,
+    sqlite::AsyncExecutor&          executor)
+{
+    sqlite::resetLatencies();
+    const ExecutorMeasurement measurement{measureReaderTasks(
+        executor,
+        /* sharedConnection */ nullptr,
+        readerTaskCount(options),
+        ReaderMode::Profiled,
+        [&options](std::size_t task) {
+            return mixedQuery(options.queryMix, task, options.rowCount);
+        })};
+    std::fprintf(
+        progressOutput,
+        "Statement latencies in microseconds over %.1f milliseconds:\n"
+        "%10s %10s %10s %10s %10s %8s  statement\n",
+        measurement.milliseconds,
+        "p50",
+        "p90",
+        "p99",
+        "p99.9",
+        "max",
+        "count");
+
+    for (const sqlite::StatementLatency& statement :
+         sqlite::latencySnapshot()) {
+        const sqlite::LatencyHistogram& histogram{statement.histogram};
+        const sqlite::BenchmarkReport::LatencyPercentiles percentiles{
+            microseconds(histogram.percentile(50.0)),
+            microseconds(histogram.percentile(90.0)),
+            microseconds(histogram.percentile(99.0)),
+            microseconds(histogram.percentile(99.9)),
+            microseconds(histogram.max())};
+        std::fprintf(
+            progressOutput,
+            "%10.1f %10.1f %10.1f %10.1f %10.1f %8llu  %s\n",
+            percentiles.p50,
+            percentiles.p90,
+            percentiles.p99,
+            percentiles.p999,
+            percentiles.max,
+            static_cast<unsigned long long>(histogram.count()),
+            statement.sql.c_str());
+        report.add(sqlite::BenchmarkReport::Result{
+            "latency, " + statement.sql,
+            histogram.count(),
+            std::chrono::duration<double, std::milli>{histogram.total()}
+                .count(),
+            std::nullopt,
+            {},
+            percentiles});
     }
+}
 
-private:
-    sqlite::DatabaseConnection* const m_conn;
-};
+// Runs the mixed reader tasks once more with cost accounting enabled and
+// prints what the virtual machine did for every statement. Accounting
+// takes a process-wide lock on every reset, so it is only enabled here.
+// The executor is a fresh one, as statements that ran before accounting
+// was enabled would add all their earlier runs.
+void benchmarkStatementCosts(const sqlite::BenchmarkOptions& options)
+{
+    sqlite::AsyncExecutor executor{
+        /* filename */ options.databasePath.c_str(),
+        /* flags */ sqlite::connectionFlags,
+        /* vfsModuleName */ options.vfs(),
+        /* threadCount */ options.threadCount};
+    sqlite::resetAccumulatedCosts();
+    sqlite::enableCostAccounting(true);
+    const auto disableCostAccounting{
+        gsl::finally([] { sqlite::enableCostAccounting(false); })};
+    measureReaderTasks(
+        executor,
+        /* sharedConnection */ nullptr,
+        readerTaskCount(options),
+        ReaderMode::ForEachRow,
+        [&options](std::size_t task) {
+            return mixedQuery(options.queryMix, task, options.rowCount);
+        });
+    std::fprintf(
+        progressOutput,
+        "Statement costs of the mixed reader tasks:\n"
+        "%8s %12s %12s %6s %10s %10s %10s  statement\n",
+        "runs",
+        "VM steps",
+        "full scan",
+        "sorts",
+        "autoindex",
+        "reprepare",
+        "memory");
+
+    for (const sqlite::SqlCosts& statement : sqlite::accumulatedCosts()) {
+        const sqlite::StatementCosts& costs{statement.costs};
+        std::fprintf(
+            progressOutput,
+            "%8llu %12llu %12llu %6llu %10llu %10llu %10llu  %s\n",
+            static_cast<unsigned long long>(costs.runCount),
+            static_cast<unsigned long long>(costs.vmSteps),
+            static_cast<unsigned long long>(costs.fullScanSteps),
+            static_cast<unsigned long long>(costs.sortCount),
+            static_cast<unsigned long long>(costs.autoIndexCount),
+            static_cast<unsigned long long>(costs.reprepareCount),
+            static_cast<unsigned long long>(costs.memoryBytes),
+            statement.sql.c_str());
+    }
+}
+
+// Runs the reader query on executor without blocking the calling thread.
+sqlite::DetachedTask readCustomersAsync(
+    sqlite::AsyncExecutor& executor,
+    std::latch&            done)
+{
+    try {
+        const std::vector<std::vector<sqlite::PreparedStatement::Variant>>
+            results{co_await executor.query(selectCustomersQuery)};
+        (void)results;
+    }
+    catch (const sqlite::Exception& ex) {
+        std::cerr << "coroutine: caught " << ex << '\n';
+    }
+    catch (const std::runtime_error& ex) {
+        std::cerr << "coroutine: caught runtime_error: " << ex.what() << '\n';
+    }
+
+    done.count_down();
+}
+
+// The reference for the executor: starts one thread per reader, each of
+// which checks a connection out of pool and runs the reader query
+// iterations times.
+double runReaderThreads(
+    const sqlite::BenchmarkOptions& options,
+    sqlite::BenchmarkReport&        report,
+    sqlite::ConnectionPool&         pool)
+{
+    std::atomic<std::uint64_t> rowCount{0};
+    const double milliseconds{timeInMilliseconds([&options, &pool, &rowCount] {
+        std::vector<std::thread> threads{};
+        auto                     threadJoiner{gsl::finally([&threads] {
+            for (std::thread& thd : threads) {
+                thd.join();
+            }
+        })};
+
+        for (std::size_t i{0}; i < options.threadCount; ++i) {
+            threads.emplace_back([&options, &pool, &rowCount] {
+                reportExceptions([&options, &pool, &rowCount] {
+                    const sqlite::ConnectionPool::Handle connection{
+                        pool.checkout()};
+
+                    for (std::size_t j{0}; j < options.iterationCount; ++j) {
+                        rowCount.fetch_add(
+                            runReaderQuery(
+                                *connection,
+                                ReaderQuery{selectCustomersQuery, 0},
+                                ReaderMode::CollectRows),
+                            std::memory_order_relaxed);
+                    }
+                });
+            });
+        }
+    })};
+    std::fprintf(
+        progressOutput,
+        "The reader threads took a total of %.1f milliseconds on %zu "
+        "threads, %llu rows read.\n",
+        milliseconds,
+        options.threadCount,
+        static_cast<unsigned long long>(rowCount.load()));
+    addResult(
+        report,
+        "reader threads, thread per reader",
+        readerTaskCount(options),
+        milliseconds);
+    return milliseconds;
+}
+
+// Runs the reader query threads * iterations times on executor, once
+// through futures and once through coroutines, and compares the throughput
+// against the plain reader tasks and against a thread per reader.
+void benchmarkAsyncExecutor(
+    const sqlite::BenchmarkOptions& options,
+    sqlite::BenchmarkReport&        report,
+    sqlite::AsyncExecutor&          executor,
+    double                          readerTaskMilliseconds,
+    double                          threadPerReaderMilliseconds)
+{
+    const std::size_t   queryCount{readerTaskCount(options)};
+    ExecutorMeasurement futures{
+        measureOnExecutor(executor, [&executor, queryCount] {
+            using Rows
+                = std::vector<std::vector<sqlite::PreparedStatement::Variant>>;
+            std::vector<std::future<Rows>> futures{};
+            futures.reserve(queryCount);
+
+            for (std::size_t i{0}; i < queryCount; ++i) {
+                futures.push_back(executor.submit(selectCustomersQuery));
+            }
+
+            for (auto& future : futures) {
+                future.get();
+            }
+        })};
+    ExecutorMeasurement coroutines{
+        measureOnExecutor(executor, [&executor, queryCount] {
+            std::latch done{static_cast<std::ptrdiff_t>(queryCount)};
+
+            for (std::size_t i{0}; i < queryCount; ++i) {
+                readCustomersAsync(executor, done);
+            }
 
-void readDataThreadFunction()
+            done.wait();
+        })};
+    std::fprintf(
+        progressOutput,
+        "%zu queries: async executor futures: %.1f milliseconds (%.0f "
+        "queries per second), coroutines: %.1f milliseconds (%.0f queries "
+        "per second), reader tasks: %.1f milliseconds (%.0f queries per "
+        "second), thread per reader: %.1f milliseconds (%.0f queries per "
+        "second).\n",
+        queryCount,
+        futures.milliseconds,
+        queriesPerSecond(queryCount, futures.milliseconds),
+        coroutines.milliseconds,
+        queriesPerSecond(queryCount, coroutines.milliseconds),
+        readerTaskMilliseconds,
+        queriesPerSecond(queryCount, readerTaskMilliseconds),
+        threadPerReaderMilliseconds,
+        queriesPerSecond(queryCount, threadPerReaderMilliseconds));
+    addResult(
+        report,
+        "async executor futures",
+        queryCount,
+        futures.milliseconds,
+        std::nullopt,
+        std::move(futures.workers));
+    addResult(
+        report,
+        "async executor coroutines",
+        queryCount,
+        coroutines.milliseconds,
+        std::nullopt,
+        std::move(coroutines.workers));
+}
+
+// Runs the reader tasks on workerCount workers after switching SQLite to
+// mode and opening the connections according to strategy.
+ExecutorMeasurement measureThreadingMode(
+    const sqlite::BenchmarkOptions& options,
+    sqlite::ThreadingMode           mode,
+    const ConnectionStrategy&       strategy,
+    std::size_t                     workerCount)
+{
+    sqlite::configureThreadingMode(mode);
+    const int flags{SQLITE_OPEN_READWRITE | strategy.mutexFlag};
+    std::optional<sqlite::DatabaseConnection> sharedConnection{};
+
+    if (strategy.sharedConnection) {
+        sharedConnection.emplace(
+            /* filename */ options.databasePath.c_str(),
+            /* flags */ flags,
+            /* vfsModuleName */ options.vfs());
+    }
+
+    // With a shared connection the workers' own connections stay unused.
+    sqlite::AsyncExecutor executor{
+        /* filename */ options.databasePath.c_str(),
+        /* flags */ flags,
+        /* vfsModuleName */ options.vfs(),
+        /* threadCount */ workerCount};
+    return measureReaderTasks(
+        executor,
+        sharedConnection.has_value() ? &*sharedConnection : nullptr,
+        readerTaskCount(options),
+        ReaderMode::ForEachRow,
+        [](std::size_t) { return ReaderQuery{selectCustomersQuery, 0}; });
+}
+
+void printThreadingMode(
+    const sqlite::BenchmarkOptions& options,
+    sqlite::BenchmarkReport&        report,
+    sqlite::ThreadingMode           mode,
+    const ConnectionStrategy&       strategy,
+    std::size_t                     workerCount)
 {
     try {
-        sqlite::DatabaseConnection* const db{getConnection()};
-        ConnectionCloser                  closer{db};
-        sqlite::DatabaseConnection&       databaseConnection{*db};
-
-        for (int i{0}; i < repeatCount; ++i) {
-            sqlite::PreparedStatement statement{
-                databaseConnection.prepareStatement(
-                    "SELECT customer_id, first_name, last_name, email, phone, "
-                    "address FROM "
-                    "customer;")};
+        ExecutorMeasurement measurement{
+            measureThreadingMode(options, mode, strategy, workerCount)};
+        std::fprintf(
+            progressOutput,
+            "  %-14s %-37s %7zu %12.1f %12.0f\n",
+            sqlite::threadingModeName(mode),
+            strategy.name,
+            workerCount,
+            measurement.milliseconds,
+            queriesPerSecond(
+                readerTaskCount(options), measurement.milliseconds));
+        addResult(
+            report,
+            std::string{"threading mode "} + sqlite::threadingModeName(mode)
+                + ", " + strategy.name,
+            readerTaskCount(options),
+            measurement.milliseconds,
+            std::nullopt,
+            std::move(measurement.workers));
+    }
+    catch (const sqlite::Exception& ex) {
+        std::fprintf(
+            progressOutput,
+            "  %-14s %-37s %7zu failed: %s\n",
+            sqlite::threadingModeName(mode),
+            strategy.name,
+            workerCount,
+            ex.message().c_str());
+    }
+}
+
+// Runs the reader tasks under every combination of sqlite3_config
+// threading mode and connection strategy. SINGLETHREAD mode is only safe
+// with a single thread using SQLite, so it runs on one worker.
+void benchmarkThreadingModes(
+    const sqlite::BenchmarkOptions& options,
+    sqlite::BenchmarkReport&        report)
+{
+    std::fprintf(
+        progressOutput,
+        "Threading modes, %zu reader tasks each:\n"
+        "  %-14s %-37s %7s %12s %12s\n",
+        readerTaskCount(options),
+        "sqlite3_config",
+        "connections",
+        "threads",
+        "milliseconds",
+        "queries/s");
+
+    for (const sqlite::ThreadingMode mode :
+         {sqlite::ThreadingMode::MultiThread,
+          sqlite::ThreadingMode::Serialized}) {
+        for (const ConnectionStrategy& strategy : connectionStrategies) {
+            printThreadingMode(
+                options, report, mode, strategy, options.threadCount);
+        }
+    }
+
+    printThreadingMode(
+        options,
+        report,
+        sqlite::ThreadingMode::SingleThread,
+        connectionStrategies[std::size(connectionStrategies) - 1],
+        1);
+    // Back to the default of SQLITE_THREADSAFE=1.
+    sqlite::configureThreadingMode(sqlite::ThreadingMode::Serialized);
+}
+
+// Prints curve, marking its knee.
+void printScalingCurve(const sqlite::ScalingCurve& curve)
+{
+    const std::optional<std::size_t> knee{curve.kneeIndex()};
+
+    for (std::size_t i{0}; i < curve.points.size(); ++i) {
+        const sqlite::ScalingPoint& point{curve.points[i]};
+        std::fprintf(
+            progressOutput,
+            "  %-14s %-37s %7zu %12.0f %12.0f%s\n",
+            curve.threadingMode.c_str(),
+            curve.connections.c_str(),
+            point.threadCount,
+            point.queriesPerSecond(),
+            point.rowsPerSecond(),
+            knee == i ? "  <- knee" : "");
+    }
+}
+
+// Runs the reader tasks at 1, 2, 4, ... up to twice the hardware threads
+// under every threading mode and connection strategy and writes the
+// throughput curves to --sweep-output. SINGLETHREAD mode can't use more
+// than one thread, so it has no curve.
+void benchmarkThreadScaling(
+    const sqlite::BenchmarkOptions& options,
+    sqlite::BenchmarkReport&        report)
+{
+    const std::vector<std::size_t> threadCounts{sqlite::sweepThreadCounts(
+        2 * std::max(std::thread::hardware_concurrency(), 1U))};
+    std::vector<sqlite::ScalingCurve> curves{};
+    std::fprintf(
+        progressOutput,
+        "Thread scaling, %zu reader tasks per point:\n"
+        "  %-14s %-37s %7s %12s %12s\n",
+        readerTaskCount(options),
+        "sqlite3_config",
+        "connections",
+        "threads",
+        "queries/s",
+        "rows/s");
+
+    for (const sqlite::ThreadingMode mode :
+         {sqlite::ThreadingMode::MultiThread,
+          sqlite::ThreadingMode::Serialized}) {
+        for (const ConnectionStrategy& strategy : connectionStrategies) {
+            sqlite::ScalingCurve curve{
+                sqlite::threadingModeName(mode), strategy.name, {}};
+
+            for (const std::size_t threadCount : threadCounts) {
+                try {
+                    ExecutorMeasurement measurement{measureThreadingMode(
+                        options, mode, strategy, threadCount)};
+                    curve.points.push_back(sqlite::ScalingPoint{
+                        threadCount,
+                        readerTaskCount(options),
+                        measurement.rowCount,
+                        measurement.milliseconds});
+                    addResult(
+                        report,
+                        std::string{"thread scaling "}
+                            + sqlite::threadingModeName(mode) + ", "
+                            + strategy.name + ", "
+                            + std::to_string(threadCount) + " threads",
+                        readerTaskCount(options),
+                        measurement.milliseconds,
+                        std::nullopt,
+                        std::move(measurement.workers));
+                }
+                catch (const sqlite::Exception& ex) {
+                    std::fprintf(
+                        progressOutput,
+                        "  %-14s %-37s %7zu failed: %s\n",
+                        sqlite::threadingModeName(mode),
+                        strategy.name,
+                        threadCount,
+                        ex.message().c_str());
+                }
+            }
+
+            printScalingCurve(curve);
+            curves.push_back(std::move(curve));
+        }
+    }
+
+    sqlite::configureThreadingMode(sqlite::ThreadingMode::Serialized);
+
+    if (options.sweepsToStdout()) {
+        sqlite::writeScalingCsv(std::cout, curves);
+        return;
+    }
+
+    std::ofstream sweepFile{options.sweepOutputPath};
+
+    if (!sweepFile) {
+        throw std::runtime_error{
+            "Could not open sweep file \"" + options.sweepOutputPath + "\""};
+    }
+
+    sqlite::writeScalingCsv(sweepFile, curves);
+}
+
+struct QueryMeasurement {
+    double milliseconds;
+    double allocationsPerQuery;
+};
+
+// Measures function, which runs the reader query iterationCount times.
+template <typename Function>
+QueryMeasurement measureQueries(std::size_t iterationCount, Function function)
+{
+    const std::uint64_t allocationsBefore{sqlite::allocationCount()};
+    const double        milliseconds{timeInMilliseconds(function)};
+    const std::uint64_t allocations{
+        sqlite::allocationCount() - allocationsBefore};
+    return QueryMeasurement{
+        milliseconds,
+        static_cast<double>(allocations)
+            / static_cast<double>(iterationCount)};
+}
+
+// Runs the reader query iterationCount times on a single reused statement
+// and hands the statement to consumeRows for every execution.
+template <typename ConsumeRows>
+QueryMeasurement measureReusedStatement(
+    sqlite::DatabaseConnection& db,
+    std::size_t                 iterationCount,
+    ConsumeRows                 consumeRows)
+{
+    sqlite::PreparedStatement statement{
+        db.prepareStatement(selectCustomersQuery)};
+    return measureQueries(
+        iterationCount, [&statement, iterationCount, &consumeRows] {
+            for (std::size_t i{0}; i < iterationCount; ++i) {
+                consumeRows(statement);
+                statement.reset();
+            }
+        });
+}
+
+void recordMeasurement(
+    const sqlite::BenchmarkOptions& options,
+    sqlite::BenchmarkReport&        report,
+    const char*                     name,
+    const QueryMeasurement&         measurement)
+{
+    std::fprintf(
+        progressOutput,
+        "  %-20s %8.1f milliseconds %10.1f allocations per query\n",
+        name,
+        measurement.milliseconds,
+        measurement.allocationsPerQuery);
+    addResult(
+        report,
+        std::string{"reader query, "} + name,
+        options.iterationCount,
+        measurement.milliseconds,
+        measurement.allocationsPerQuery);
+}
+
+// Compares ways of preparing the reader query and of consuming its rows.
+void benchmarkReaderQuery(
+    const sqlite::BenchmarkOptions& options,
+    sqlite::BenchmarkReport&        report,
+    sqlite::DatabaseConnection&     db)
+{
+    const std::size_t      iterations{options.iterationCount};
+    const QueryMeasurement prepared{
+        measureQueries(iterations, [&db, iterations] {
+            for (std::size_t i{0}; i < iterations; ++i) {
+                sqlite::PreparedStatement statement{
+                    db.prepareStatement(selectCustomersQuery)};
+                statement.run();
+            }
+        })};
+    const QueryMeasurement cached{
+        measureQueries(iterations, [&db, iterations] {
+            for (std::size_t i{0}; i < iterations; ++i) {
+                readCustomers(db);
+            }
+        })};
+    const QueryMeasurement collected{measureReusedStatement(
+        db, iterations, [](sqlite::PreparedStatement& statement) {
             const std::vector<std::vector<sqlite::PreparedStatement::Variant>>
                 results{statement.run()};
             (void)results;
+        })};
+    std::vector<std::byte> arenaBuffer(arenaBufferSize);
+    const QueryMeasurement arena{measureReusedStatement(
+        db, iterations, [&arenaBuffer](sqlite::PreparedStatement& statement) {
+            std::pmr::monotonic_buffer_resource arena{
+                arenaBuffer.data(), arenaBuffer.size()};
+            const std::pmr::vector<
+                std::pmr::vector<sqlite::PreparedStatement::PmrVariant>>
+                results{statement.run(&arena)};
+            (void)results;
+        })};
+    const QueryMeasurement streamed{measureReusedStatement(
+        db, iterations, [](sqlite::PreparedStatement& statement) {
+            for (const sqlite::Row row : statement.rows()) {
+                for (int i{0}; i < row.columnCount(); ++i) {
+                    const sqlite::Row::Variant value{row.value(i)};
+                    (void)value;
+                }
+            }
+        })};
+    const QueryMeasurement views{measureReusedStatement(
+        db, iterations, [](sqlite::PreparedStatement& statement) {
+            std::size_t byteCount{0};
+
+            for (const sqlite::Row row : statement.rows()) {
+                for (int i{1}; i < row.columnCount(); ++i) {
+                    byteCount += row.textView(i).size();
+                }
+            }
+
+            (void)byteCount;
+        })};
+    const QueryMeasurement generated{measureReusedStatement(
+        db, iterations, [](sqlite::PreparedStatement& statement) {
+            std::size_t rowCount{0};
+
+            for (const sqlite::Row& row : statement.generateRows()) {
+                (void)row;
+                ++rowCount;
+            }
+
+            (void)rowCount;
+        })};
+    const QueryMeasurement forEach{measureReusedStatement(
+        db, iterations, [](sqlite::PreparedStatement& statement) {
+            const std::size_t rowCount{
+                statement.forEach([](const sqlite::Row&) {})};
+            (void)rowCount;
+        })};
+    const QueryMeasurement typed{measureReusedStatement(
+        db, iterations, [](sqlite::PreparedStatement& statement) {
+            const std::vector<Customer> customers{
+                statement.query<Customer>()};
+            (void)customers;
+        })};
+    sqlite::Statement<Customer()> selectCustomers{
+        db.prepareStatement(selectCustomersQuery)};
+    const QueryMeasurement typedStatement{
+        measureQueries(iterations, [&selectCustomers, iterations] {
+            for (std::size_t i{0}; i < iterations; ++i) {
+                const std::vector<Customer> customers{selectCustomers()};
+                (void)customers;
+            }
+        })};
+    const QueryMeasurement columnar{measureReusedStatement(
+        db, iterations, [](sqlite::PreparedStatement& statement) {
+            const sqlite::ColumnarResult result{statement.runColumnar()};
+            sqlite3_int64                checksum{0};
+
+            for (const sqlite3_int64 customerId :
+                 result.column(0).integers()) {
+                checksum += customerId;
+            }
+
+            (void)checksum;
+        })};
+    std::fprintf(
+        progressOutput, "Reader query, %zu executions:\n", iterations);
+    recordMeasurement(options, report, "prepared every time", prepared);
+    recordMeasurement(options, report, "statement cache", cached);
+    recordMeasurement(options, report, "collected rows", collected);
+    recordMeasurement(options, report, "arena rows", arena);
+    recordMeasurement(options, report, "streamed rows", streamed);
+    recordMeasurement(options, report, "row views", views);
+    recordMeasurement(options, report, "generated rows", generated);
+    recordMeasurement(options, report, "forEach rows", forEach);
+    recordMeasurement(options, report, "typed rows", typed);
+    recordMeasurement(options, report, "typed Statement<>", typedStatement);
+    recordMeasurement(options, report, "columnar rows", columnar);
+
+    const sqlite::StatementCache::Statistics statistics{
+        db.statementCacheStatistics()};
+    std::fprintf(
+        progressOutput,
+        "Statement cache: %llu hits, %llu misses, %llu evictions, %zu of %zu "
+        "entries cached.\n",
+        static_cast<unsigned long long>(statistics.hits),
+        static_cast<unsigned long long>(statistics.misses),
+        static_cast<unsigned long long>(statistics.evictions),
+        statistics.size,
+        statistics.capacity);
+}
+
+template <typename Worker>
+double timeShortLivedWorkers(std::size_t threadCount, Worker worker)
+{
+    return timeInMilliseconds([threadCount, &worker] {
+        for (int round{0}; round < workerRounds; ++round) {
+            std::vector<std::thread> threads{};
+
+            for (std::size_t i{0}; i < threadCount; ++i) {
+                threads.emplace_back([&worker] { reportExceptions(worker); });
+            }
+
+            for (std::thread& thd : threads) {
+                thd.join();
+            }
         }
+    });
+}
+
+// Short-lived workers that each run a single query: compares opening a
+// connection per worker against checking one out of the pool.
+void benchmarkConnectionAcquisition(
+    const sqlite::BenchmarkOptions& options,
+    sqlite::BenchmarkReport&        report,
+    sqlite::ConnectionPool&         pool)
+{
+    const double perThreadTime{
+        timeShortLivedWorkers(options.threadCount, [&options] {
+            const std::unique_ptr<sqlite::DatabaseConnection> connection{
+                new sqlite::DatabaseConnection{
+                    /* filename */ options.databasePath.c_str(),
+                    /* flags */ connectionFlags,
+                    /* vfsModuleName */ options.vfs()}};
+            readCustomers(*connection);
+        })};
+    const double pooledTime{
+        timeShortLivedWorkers(options.threadCount, [&pool] {
+            const sqlite::ConnectionPool::Handle connection{pool.checkout()};
+            readCustomers(*connection);
+        })};
+    std::fprintf(
+        progressOutput,
+        "Short-lived workers (%d x %zu): connection per thread: %.1f "
+        "milliseconds, connection pool: %.1f milliseconds.\n",
+        workerRounds,
+        options.threadCount,
+        perThreadTime,
+        pooledTime);
+    const std::size_t workerCount{workerRounds * options.threadCount};
+    addResult(
+        report,
+        "short-lived workers, connection per thread",
+        workerCount,
+        perThreadTime);
+    addResult(
+        report,
+        "short-lived workers, connection pool",
+        workerCount,
+        pooledTime);
+}
+
+// Prints what the trace profiler saw of every statement that ran on any
+// connection since the process started, including the PRAGMAs and the DDL.
+void reportStatementProfiles(sqlite::BenchmarkReport& report)
+{
+    std::fprintf(
+        progressOutput,
+        "Statement profiles:\n%8s %10s %12s %10s %10s %10s  statement\n",
+        "runs",
+        "rows",
+        "total ms",
+        "min us",
+        "avg us",
+        "max us");
+
+    for (const sqlite::StatementProfile& profile :
+         sqlite::statementProfiles()) {
+        const double totalMilliseconds{
+            std::chrono::duration<double, std::milli>{profile.totalTime}
+                .count()};
+        std::fprintf(
+            progressOutput,
+            "%8llu %10llu %12.3f %10.1f %10.1f %10.1f  %s\n",
+            static_cast<unsigned long long>(profile.runCount),
+            static_cast<unsigned long long>(profile.rowCount),
+            totalMilliseconds,
+            microseconds(profile.minTime),
+            microseconds(profile.totalTime)
+                / static_cast<double>(profile.runCount),
+            microseconds(profile.maxTime),
+            profile.sql.c_str());
+        addResult(
+            report,
+            "statement profile, " + profile.sql,
+            profile.runCount,
+            totalMilliseconds);
     }
-    catch (const sqlite::Exception& ex) {
-        std::cerr << "std::thread: caught " << ex << '\n';
+}
+
+// Prints how the throughput of every benchmark differs from baseline.
+void printBaselineComparison(
+    const sqlite::BenchmarkReport&           report,
+    const sqlite::BenchmarkReport::Baseline& baseline)
+{
+    std::fprintf(
+        progressOutput,
+        "Throughput of the %s SQLite build against the %s baseline:\n"
+        "%14s %14s %9s  benchmark\n",
+        sqlite::BenchmarkReport::sqliteBuildProfile(),
+        baseline.sqliteBuildProfile.c_str(),
+        "baseline op/s",
+        "op/s",
+        "delta");
+
+    for (const sqlite::BenchmarkReport::Result& result : report.results()) {
+        const auto it{baseline.operationsPerSecond.find(result.name)};
+
+        if (it == baseline.operationsPerSecond.end() || it->second <= 0.0) {
+            continue;
+        }
+
+        std::fprintf(
+            progressOutput,
+            "%14.1f %14.1f %+8.1f%%  %s\n",
+            it->second,
+            result.operationsPerSecond(),
+            (result.operationsPerSecond() / it->second - 1.0) * 100.0,
+            result.name.c_str());
     }
-    catch (const std::runtime_error& ex) {
-        std::cerr << "std::thrtead: caught runtime_error: " << ex.what()
-                  << '\n';
+}
+
+void writeReport(
+    const sqlite::BenchmarkOptions& options,
+    const sqlite::BenchmarkReport&  report)
+{
+    if (options.reportFormat == sqlite::ReportFormat::Text) {
+        return;
+    }
+
+    std::ofstream reportFile{};
+
+    if (!options.reportsToStdout()) {
+        reportFile.open(options.outputPath);
+
+        if (!reportFile) {
+            throw std::runtime_error{
+                "Could not open report file \"" + options.outputPath + "\""};
+        }
+    }
+
+    std::ostream& os{
+        options.reportsToStdout() ? std::cout
+                                  : static_cast<std::ostream&>(reportFile)};
+
+    if (options.reportFormat == sqlite::ReportFormat::Json) {
+        report.writeJson(os);
+    }
+    else {
+        report.writeCsv(os);
     }
 }
 
@@ -117,81 +1411,150 @@ bool isRootPath(const std::filesystem::path& path)
 } // anonymous namespace
 } // namespace sqlite
 
-int main()
+int main(int argc, char** argv)
 {
     try {
+        sqlite::BenchmarkOptions options{
+            sqlite::parseBenchmarkOptions(argc, argv)};
+
+        if (options.helpRequested) {
+            std::fputs(sqlite::benchmarkUsage(), stdout);
+            return EXIT_SUCCESS;
+        }
+
+        if (options.reportsToStdout() || options.sweepsToStdout()) {
+            sqlite::progressOutput = stderr;
+        }
+
+        // Relative paths refer to the directory the app was started in.
+        options.databasePath
+            = std::filesystem::absolute(options.databasePath).string();
+
+        if (options.outputPath != "-") {
+            options.outputPath
+                = std::filesystem::absolute(options.outputPath).string();
+        }
+
+        if (!options.sweepOutputPath.empty() && !options.sweepsToStdout()) {
+            options.sweepOutputPath
+                = std::filesystem::absolute(options.sweepOutputPath).string();
+        }
+
+        std::optional<sqlite::BenchmarkReport::Baseline> baseline{};
+
+        if (!options.baselinePath.empty()) {
+            std::ifstream baselineFile{options.baselinePath};
+
+            if (!baselineFile) {
+                throw std::runtime_error{
+                    "Could not open baseline report \"" + options.baselinePath
+                    + "\""};
+            }
+
+            baseline = sqlite::BenchmarkReport::readCsvBaseline(baselineFile);
+        }
+
         while (!sqlite::isRootPath(std::filesystem::current_path())) {
+            if (!std::filesystem::current_path().has_relative_path()) {
+                throw std::runtime_error{
+                    "emails.txt not found in the working directory or above"};
+            }
+
             std::filesystem::current_path(
                 std::filesystem::current_path().parent_path());
         }
 
         std::vector<std::string> emails{sqlite::loadEmails()};
 
-        if (std::filesystem::exists(SQLITE_DATABASE_FILE_NAME)) {
-            std::remove(SQLITE_DATABASE_FILE_NAME);
+        if (std::filesystem::exists(options.databasePath)) {
+            std::remove(options.databasePath.c_str());
         }
 
-        sqlite::DatabaseConnection* const db{sqlite::getConnection()};
-        sqlite::ConnectionCloser          closer{db};
-        sqlite::PreparedStatement createTableStatement{db->prepareStatement(R"(
-    CREATE TABLE customer (
-      customer_id INTEGER PRIMARY KEY,
-      first_name TEXT NOT NULL,
-      last_name TEXT NOT NULL,
-      email TEXT NOT NULL,
-      phone TEXT,
-      address TEXT
-    );)")};
-        createTableStatement.run();
-
-        for (int i{0}; i < sqlite::repeatCount; ++i) {
-            assert(!emails.empty() && "No more e-mails left.");
-            sqlite::PreparedStatement insertStatement{db->prepareStatement(
-                "INSERT INTO customer (first_name, last_name, email, phone, "
-                "address) "
-                "VALUES (?, ?, ?, ?, ?);")};
-            insertStatement.bind(1, "John");
-            insertStatement.bind(2, "Doe");
-            insertStatement.bind(3, emails.back().c_str());
-            insertStatement.bind(4, "+12345678");
-            insertStatement.bind(5, "123 Main St");
-            insertStatement.run();
-            emails.pop_back();
-        }
-
-        pl::timer timer{};
-        auto      timePrinter{gsl::finally([&timer] {
-            const std::chrono::steady_clock::duration elapsedTime{
-                timer.elapsed_time()};
-            std::ostringstream oss{};
-            oss << "The reading threads took a total of "
-                << std::chrono::duration_cast<std::chrono::milliseconds>(
-                       elapsedTime)
-                       .count()
-                << " milliseconds. ";
-#if USE_MUTEX
-            oss << "Threading mode: SQLITE_OPEN_FULLMUTEX";
-#else
-            oss << "Threading mode: SQLITE_OPEN_NOMUTEX";
-#endif
-            std::printf("%s\n", oss.str().c_str());
-        })};
+        sqlite::BenchmarkReport report{options};
 
-        std::vector<std::thread> threads{};
-        auto                     threadJoiner{gsl::finally([&threads] {
-            for (std::thread& thd : threads) {
-                thd.join();
+        {
+            sqlite::ConnectionPool pool{
+                /* filename */ options.databasePath.c_str(),
+                /* flags */ sqlite::connectionFlags,
+                /* vfsModuleName */ options.vfs(),
+                /* size */ options.threadCount};
+            {
+                const sqlite::ConnectionPool::Handle connection{
+                    pool.checkout()};
+                sqlite::DatabaseConnection&          db{*connection};
+                std::vector<std::string>             customerEmails{};
+                sqlite::printStatusDeltas("creating customers", &db, [&] {
+                    customerEmails
+                        = sqlite::createCustomers(options, report, db, emails);
+                });
+                sqlite::printStatusDeltas("e-mail lookups", &db, [&] {
+                    sqlite::benchmarkEmailLookup(report, db, customerEmails);
+                });
+                sqlite::printStatusDeltas("reader queries", &db, [&] {
+                    sqlite::benchmarkReaderQuery(options, report, db);
+                });
+                sqlite::printScanStatus(db);
             }
-        })};
 
-        for (std::size_t i{0}; i < sqlite::threadCount; ++i) {
-            threads.emplace_back(&sqlite::readDataThreadFunction);
+            sqlite::printStatusDeltas("connection acquisition", nullptr, [&] {
+                sqlite::benchmarkConnectionAcquisition(options, report, pool);
+            });
+
+            // The executor's connections belong to its workers, so only the
+            // process-wide status is printed for its runs.
+            sqlite::AsyncExecutor executor{
+                /* filename */ options.databasePath.c_str(),
+                /* flags */ sqlite::connectionFlags,
+                /* vfsModuleName */ options.vfs(),
+                /* threadCount */ options.threadCount};
+            double readerTaskTime{0.0};
+            sqlite::printStatusDeltas("reader tasks", nullptr, [&] {
+                readerTaskTime = sqlite::runReaderTasks(
+                    options,
+                    report,
+                    executor,
+                    sqlite::ReaderMode::CollectRows);
+                sqlite::runReaderTasks(
+                    options, report, executor, sqlite::ReaderMode::ForEachRow);
+            });
+            sqlite::printStatusDeltas("mixed reader tasks", nullptr, [&] {
+                sqlite::benchmarkQueryMix(options, report, executor);
+                sqlite::benchmarkLatencies(options, report, executor);
+                sqlite::benchmarkStatementCosts(options);
+            });
+            sqlite::printStatusDeltas("async queries", nullptr, [&] {
+                const double threadPerReaderTime{
+                    sqlite::runReaderThreads(options, report, pool)};
+                sqlite::benchmarkAsyncExecutor(
+                    options,
+                    report,
+                    executor,
+                    readerTaskTime,
+                    threadPerReaderTime);
+            });
+        }
+
+        // Reconfigures SQLite, so every connection has to be closed by now.
+        sqlite::benchmarkThreadingModes(options, report);
+
+        if (!options.sweepOutputPath.empty()) {
+            sqlite::benchmarkThreadScaling(options, report);
         }
+
+        sqlite::reportStatementProfiles(report);
+
+        if (baseline.has_value()) {
+            sqlite::printBaselineComparison(report, *baseline);
+        }
+
+        sqlite::writeReport(options, report);
     }
     catch (const sqlite::Exception& ex) {
         std::cerr << "Main thread: caught " << ex << '\n';
+        return EXIT_FAILURE;
     }
     catch (const std::runtime_error& ex) {
         std::cerr << "Main thread: caught runtime_error: " << ex.what() << '\n';
+        return EXIT_FAILURE;
     }
 }
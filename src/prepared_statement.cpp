@@ -1,7 +1,6 @@
 #include <cstdio>
-#include <cstring>
 
-#include <sstream>
+#include <utility>
 
 #include <gsl/util>
 
@@ -9,6 +8,7 @@
 
 #include "as_string.hpp"
 #include "exception.hpp"
+#include "latency_recorder.hpp"
 #include "prepared_statement.hpp"
 #include "throw.hpp"
 
@@ -17,12 +17,42 @@ PreparedStatement::PreparedStatement(
     sqlite3*      db,
     sqlite3_stmt* statement,
     const char*   sqlQuery)
-    : m_db{db}, m_statement{statement}, m_sqlQuery{sqlQuery}
+    : m_db{db}
+    , m_statement{statement}
+    , m_sqlQuery{sqlQuery}
+    , m_parameterIndices{}
 {
 }
 
+PreparedStatement::PreparedStatement(PreparedStatement&& other) noexcept
+    : m_db{other.m_db}
+    , m_statement{other.m_statement}
+    , m_sqlQuery{other.m_sqlQuery}
+    , m_parameterIndices{std::move(other.m_parameterIndices)}
+{
+    other.m_statement = nullptr;
+}
+
+PreparedStatement& PreparedStatement::operator=(
+    PreparedStatement&& other) noexcept
+{
+    std::swap(m_db, other.m_db);
+    std::swap(m_statement, other.m_statement);
+    std::swap(m_sqlQuery, other.m_sqlQuery);
+    std::swap(m_parameterIndices, other.m_parameterIndices);
+    return *this;
+}
+
 PreparedStatement::~PreparedStatement()
 {
+    if (m_statement == nullptr) {
+        return;
+    }
+
+    if (costAccountingEnabled()) {
+        accumulateCosts();
+    }
+
     const int resultCode{sqlite3_finalize(m_statement)};
 
     if (resultCode != SQLITE_OK) {
@@ -80,10 +110,81 @@ void PreparedStatement::bind(int placeholderIndex, sqlite3_int64 value)
 
 void PreparedStatement::bind(int placeholderIndex, const char* text)
 {
-    const std::size_t length = std::strlen(text);
-    const std::size_t bytes  = length + 1;
-    const int         resultCode{sqlite3_bind_text(
-        m_statement, placeholderIndex, text, bytes, SQLITE_TRANSIENT)};
+    bindText(placeholderIndex, std::string_view{text}, SQLITE_TRANSIENT);
+}
+
+void PreparedStatement::bind(int placeholderIndex, std::string_view text)
+{
+    bindText(placeholderIndex, text, SQLITE_TRANSIENT);
+}
+
+void PreparedStatement::bind(int placeholderIndex, BorrowedText text)
+{
+    bindText(placeholderIndex, text.text, SQLITE_STATIC);
+}
+
+void PreparedStatement::bind(
+    int                        placeholderIndex,
+    std::span<const std::byte> bytes)
+{
+    bindBlob(placeholderIndex, bytes, SQLITE_TRANSIENT);
+}
+
+void PreparedStatement::bind(int placeholderIndex, BorrowedBlob bytes)
+{
+    bindBlob(placeholderIndex, bytes.bytes, SQLITE_STATIC);
+}
+
+int PreparedStatement::parameterCount() const
+{
+    return sqlite3_bind_parameter_count(m_statement);
+}
+
+int PreparedStatement::parameterIndex(const ParameterName& name)
+{
+    for (const CachedParameterIndex& cached : m_parameterIndices) {
+        // Different names can share a hash, so the name has to match too.
+        if (cached.nameHash == name.hash()
+            && std::string_view{sqlite3_bind_parameter_name(
+                   m_statement, cached.index)}
+                   == name.name()) {
+            return cached.index;
+        }
+    }
+
+    const std::string nullTerminatedName{name.name()};
+    const int         index{
+        sqlite3_bind_parameter_index(m_statement, nullTerminatedName.c_str())};
+
+    if (index == 0) {
+        SQLITE_THROW(
+            Exception,
+            SQLITE_RANGE,
+            "Unknown parameter \"{}\". Query: {}",
+            nullTerminatedName,
+            m_sqlQuery);
+    }
+
+    m_parameterIndices.push_back(CachedParameterIndex{name.hash(), index});
+    return index;
+}
+
+void PreparedStatement::throwBindError(int resultCode) const
+{
+    SQLITE_THROW(
+        Exception,
+        resultCode,
+        "Failed to bind parameters: \"{}\"",
+        sqlite3_errmsg(m_db));
+}
+
+void PreparedStatement::bindText(
+    int                     placeholderIndex,
+    std::string_view        text,
+    sqlite3_destructor_type destructor)
+{
+    const int resultCode{
+        bindTextParameter(m_statement, placeholderIndex, text, destructor)};
 
     if (resultCode != SQLITE_OK) {
         SQLITE_THROW(
@@ -94,65 +195,52 @@ void PreparedStatement::bind(int placeholderIndex, const char* text)
     }
 }
 
-static std::vector<PreparedStatement::Variant> extractRow(
-    sqlite3_stmt* statement)
+void PreparedStatement::bindBlob(
+    int                        placeholderIndex,
+    std::span<const std::byte> bytes,
+    sqlite3_destructor_type    destructor)
 {
-    using Variant = PreparedStatement::Variant;
-    const int            columns{sqlite3_column_count(statement)};
-    std::vector<Variant> row{};
-
-    for (int i = 0; i < columns; ++i) {
-        const int type{sqlite3_column_type(statement, i)};
+    const int resultCode{
+        bindBlobParameter(m_statement, placeholderIndex, bytes, destructor)};
 
-        switch (type) {
-        case SQLITE_INTEGER:
-            row.push_back(Variant{sqlite3_column_int64(statement, i)});
-            break;
-        case SQLITE_FLOAT:
-            row.push_back(Variant{sqlite3_column_double(statement, i)});
-            break;
-        case SQLITE_TEXT: {
-            const unsigned char* const memory{
-                sqlite3_column_text(statement, i)};
-            const std::string string{reinterpret_cast<const char*>(memory)};
-            row.push_back(Variant{string});
-            break;
-        }
-        case SQLITE_BLOB:
-            throw std::runtime_error{
-                "PreparedStatement: BLOB is not handled yet."};
-        case SQLITE_NULL:
-            throw std::runtime_error{
-                "PreparedStatement: NULL is not handled yet."};
-        }
+    if (resultCode != SQLITE_OK) {
+        SQLITE_THROW(
+            Exception,
+            resultCode,
+            "Failed to bind blob: \"{}\"",
+            sqlite3_errmsg(m_db));
     }
-
-    return row;
 }
 
 std::vector<std::vector<PreparedStatement::Variant>> PreparedStatement::run()
 {
     std::vector<std::vector<Variant>> result{};
-    int                               returnCode{};
 
-    for (;;) {
-        returnCode = sqlite3_step(m_statement);
+    while (step()) {
+        result.push_back(row().toOwned());
+    }
 
-        switch (returnCode) {
-        case SQLITE_DONE:
-            return result;
-        case SQLITE_ROW: {
-            const std::vector<Variant> row{extractRow(m_statement)};
-            result.push_back(row);
-            break;
-        }
-        default:
-            SQLITE_THROW(
-                Exception,
-                returnCode,
-                "sqlite3_step failed. Query: {}",
-                m_sqlQuery);
-        }
+    return result;
+}
+
+std::pmr::vector<std::pmr::vector<PreparedStatement::PmrVariant>>
+PreparedStatement::run(std::pmr::memory_resource* memoryResource)
+{
+    std::pmr::vector<std::pmr::vector<PmrVariant>> result{memoryResource};
+
+    while (step()) {
+        result.push_back(row().toOwned(memoryResource));
+    }
+
+    return result;
+}
+
+ColumnarResult PreparedStatement::runColumnar()
+{
+    ColumnarResult result{row()};
+
+    while (step()) {
+        result.append(row());
     }
 
     return result;
@@ -163,17 +251,173 @@ PreparedStatement::runProfiled()
 {
     pl::timer timer{};
     auto      finalAction{gsl::finally([this, &timer] {
-        const std::chrono::steady_clock::duration elapsedTime{
-            timer.elapsed_time()};
-        std::ostringstream oss{};
-        oss << '"' << m_sqlQuery << "\" took "
-            << std::chrono::duration_cast<std::chrono::microseconds>(
-                   elapsedTime)
-                   .count()
-            << " microseconds.";
-        std::printf("%s\n", oss.str().c_str());
+        recordLatency(m_sqlQuery, timer.elapsed_time());
     })};
     return run();
 }
 
+bool PreparedStatement::step()
+{
+    const int returnCode{sqlite3_step(m_statement)};
+
+    switch (returnCode) {
+    case SQLITE_ROW:
+        return true;
+    case SQLITE_DONE:
+        return false;
+    default:
+        SQLITE_THROW(
+            Exception,
+            returnCode,
+            "sqlite3_step failed. Query: {}",
+            m_sqlQuery);
+    }
+}
+
+Row PreparedStatement::row() const
+{
+    return Row{m_statement};
+}
+
+RowRange PreparedStatement::rows()
+{
+    return RowRange{this};
+}
+
+Generator<Row> PreparedStatement::generateRows()
+{
+    while (step()) {
+        co_yield row();
+    }
+}
+
+void PreparedStatement::reset() noexcept
+{
+    if (costAccountingEnabled()) {
+        accumulateCosts();
+    }
+
+    sqlite3_reset(m_statement);
+}
+
+void PreparedStatement::clearBindings() noexcept
+{
+    sqlite3_clear_bindings(m_statement);
+}
+
+StatementCosts PreparedStatement::costs() const
+{
+    return StatementCosts{
+        status(SQLITE_STMTSTATUS_VM_STEP, false),
+        status(SQLITE_STMTSTATUS_FULLSCAN_STEP, false),
+        status(SQLITE_STMTSTATUS_SORT, false),
+        status(SQLITE_STMTSTATUS_AUTOINDEX, false),
+        status(SQLITE_STMTSTATUS_REPREPARE, false),
+        status(SQLITE_STMTSTATUS_RUN, false),
+        status(SQLITE_STMTSTATUS_MEMUSED, false)};
+}
+
+#ifdef SQLITE_ENABLE_STMT_SCANSTATUS
+std::vector<PlanElementStatus> PreparedStatement::scanStatus() const
+{
+    std::vector<PlanElementStatus> elements{};
+
+    for (int index{0};; ++index) {
+        const auto scanStatusOf{[this, index](int operation, void* out) {
+            return sqlite3_stmt_scanstatus_v2(
+                       m_statement,
+                       index,
+                       operation,
+                       SQLITE_SCANSTAT_COMPLEX,
+                       out)
+                   == 0;
+        }};
+        PlanElementStatus element{};
+
+        // Fails once index is past the last element.
+        if (!scanStatusOf(SQLITE_SCANSTAT_SELECTID, &element.selectId)) {
+            break;
+        }
+
+        scanStatusOf(SQLITE_SCANSTAT_PARENTID, &element.parentId);
+        const char* text{nullptr};
+
+        if (scanStatusOf(SQLITE_SCANSTAT_EXPLAIN, &text) && text != nullptr) {
+            element.explain = text;
+        }
+
+        text = nullptr;
+
+        if (scanStatusOf(SQLITE_SCANSTAT_NAME, &text) && text != nullptr) {
+            element.name = text;
+        }
+
+        // SQLite reports figures it doesn't have as -1.
+        sqlite3_int64 value{-1};
+
+        if (scanStatusOf(SQLITE_SCANSTAT_NLOOP, &value) && value >= 0) {
+            element.loopCount = value;
+        }
+
+        value = -1;
+
+        if (scanStatusOf(SQLITE_SCANSTAT_NVISIT, &value) && value >= 0) {
+            element.visitedRowCount = value;
+        }
+
+        value = -1;
+
+        if (scanStatusOf(SQLITE_SCANSTAT_NCYCLE, &value) && value >= 0) {
+            element.cycleCount = value;
+        }
+
+        double estimate{-1.0};
+
+        if (scanStatusOf(SQLITE_SCANSTAT_EST, &estimate) && estimate >= 0.0) {
+            element.estimatedRowsPerLoop = estimate;
+        }
+
+        elements.push_back(std::move(element));
+    }
+
+    return elements;
+}
+
+void PreparedStatement::resetScanStatus() noexcept
+{
+    sqlite3_stmt_scanstatus_reset(m_statement);
+}
+#endif
+
+std::uint64_t PreparedStatement::status(int counter, bool resetCounter) const
+{
+    return static_cast<std::uint64_t>(
+        sqlite3_stmt_status(m_statement, counter, resetCounter ? 1 : 0));
+}
+
+void PreparedStatement::accumulateCosts() noexcept
+{
+    // Resetting the counters keeps the next run from being counted twice;
+    // SQLite ignores the reset of the memory used.
+    const StatementCosts costs{
+        status(SQLITE_STMTSTATUS_VM_STEP, true),
+        status(SQLITE_STMTSTATUS_FULLSCAN_STEP, true),
+        status(SQLITE_STMTSTATUS_SORT, true),
+        status(SQLITE_STMTSTATUS_AUTOINDEX, true),
+        status(SQLITE_STMTSTATUS_REPREPARE, true),
+        status(SQLITE_STMTSTATUS_RUN, true),
+        status(SQLITE_STMTSTATUS_MEMUSED, false)};
+
+    try {
+        sqlite::accumulateCosts(m_sqlQuery, costs);
+    }
+    catch (const std::exception& ex) {
+        std::fprintf(
+            stderr,
+            "Failed to accumulate the costs of \"%s\": %s\n",
+            m_sqlQuery,
+            ex.what());
+    }
+}
+
 } // namespace sqlite
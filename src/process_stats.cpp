@@ -0,0 +1,57 @@
+#include <sqlite3.h>
+
+#include "exception.hpp"
+#include "process_stats.hpp"
+#include "throw.hpp"
+
+namespace sqlite {
+namespace {
+struct Status {
+    sqlite3_int64 current;
+    sqlite3_int64 highwater;
+};
+
+Status status(int operation)
+{
+    Status    status{0, 0};
+    const int resultCode{sqlite3_status64(
+        /* op */ operation,
+        /* pCurrent */ &status.current,
+        /* pHighwater */ &status.highwater,
+        /* resetFlag */ 0)};
+
+    if (resultCode != SQLITE_OK) {
+        SQLITE_THROW(
+            Exception,
+            resultCode,
+            "sqlite3_status64 failed for operation {}",
+            operation);
+    }
+
+    return status;
+}
+} // anonymous namespace
+
+ProcessStats ProcessStats::operator-(const ProcessStats& before) const
+{
+    return ProcessStats{
+        memoryBytes - before.memoryBytes,
+        memoryHighwaterBytes,
+        outstandingAllocations - before.outstandingAllocations,
+        largestAllocationBytes,
+        pageCachePages - before.pageCachePages,
+        pageCacheOverflowBytes - before.pageCacheOverflowBytes};
+}
+
+ProcessStats processStats()
+{
+    const Status memory{status(SQLITE_STATUS_MEMORY_USED)};
+    return ProcessStats{
+        memory.current,
+        memory.highwater,
+        status(SQLITE_STATUS_MALLOC_COUNT).current,
+        status(SQLITE_STATUS_MALLOC_SIZE).highwater,
+        status(SQLITE_STATUS_PAGECACHE_USED).current,
+        status(SQLITE_STATUS_PAGECACHE_OVERFLOW).current};
+}
+} // namespace sqlite
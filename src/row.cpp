@@ -0,0 +1,128 @@
+#include <stdexcept>
+
+#include "row.hpp"
+
+namespace sqlite {
+Row::Row(sqlite3_stmt* statement) : m_statement{statement}
+{
+}
+
+int Row::columnCount() const
+{
+    return sqlite3_column_count(m_statement);
+}
+
+int Row::columnType(int column) const
+{
+    return sqlite3_column_type(m_statement, column);
+}
+
+const char* Row::columnName(int column) const
+{
+    return sqlite3_column_name(m_statement, column);
+}
+
+sqlite3_int64 Row::int64(int column) const
+{
+    return sqlite3_column_int64(m_statement, column);
+}
+
+double Row::real(int column) const
+{
+    return sqlite3_column_double(m_statement, column);
+}
+
+const char* Row::text(int column) const
+{
+    return reinterpret_cast<const char*>(
+        sqlite3_column_text(m_statement, column));
+}
+
+std::string_view Row::textView(int column) const
+{
+    return get<std::string_view>(column);
+}
+
+std::span<const std::byte> Row::blob(int column) const
+{
+    return get<std::span<const std::byte>>(column);
+}
+
+Row::Variant Row::value(int column) const
+{
+    switch (columnType(column)) {
+    case SQLITE_INTEGER:
+        return Variant{int64(column)};
+    case SQLITE_FLOAT:
+        return Variant{real(column)};
+    case SQLITE_TEXT:
+        return Variant{get<std::string>(column)};
+    case SQLITE_BLOB: {
+        const std::span<const std::byte> bytes{blob(column)};
+        return Variant{std::vector<std::byte>{bytes.begin(), bytes.end()}};
+    }
+    case SQLITE_NULL:
+        throw std::runtime_error{
+            "PreparedStatement: NULL is not handled yet."};
+    }
+
+    throw std::runtime_error{"PreparedStatement: unknown column type."};
+}
+
+std::vector<Row::Variant> Row::toOwned() const
+{
+    const int            columns{columnCount()};
+    std::vector<Variant> result{};
+    result.reserve(static_cast<std::size_t>(columns));
+
+    for (int i{0}; i < columns; ++i) {
+        result.push_back(value(i));
+    }
+
+    return result;
+}
+
+Row::PmrVariant Row::value(
+    int                        column,
+    std::pmr::memory_resource* memoryResource) const
+{
+    switch (columnType(column)) {
+    case SQLITE_INTEGER:
+        return PmrVariant{int64(column)};
+    case SQLITE_FLOAT:
+        return PmrVariant{real(column)};
+    case SQLITE_TEXT:
+        return PmrVariant{
+            std::in_place_type<std::pmr::string>,
+            textView(column),
+            memoryResource};
+    case SQLITE_BLOB: {
+        const std::span<const std::byte> bytes{blob(column)};
+        return PmrVariant{
+            std::in_place_type<std::pmr::vector<std::byte>>,
+            bytes.begin(),
+            bytes.end(),
+            memoryResource};
+    }
+    case SQLITE_NULL:
+        throw std::runtime_error{
+            "PreparedStatement: NULL is not handled yet."};
+    }
+
+    throw std::runtime_error{"PreparedStatement: unknown column type."};
+}
+
+std::pmr::vector<Row::PmrVariant> Row::toOwned(
+    std::pmr::memory_resource* memoryResource) const
+{
+    const int                    columns{columnCount()};
+    std::pmr::vector<PmrVariant> result{memoryResource};
+    result.reserve(static_cast<std::size_t>(columns));
+
+    for (int i{0}; i < columns; ++i) {
+        result.push_back(value(i, memoryResource));
+    }
+
+    return result;
+}
+} // namespace sqlite
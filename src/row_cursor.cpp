@@ -0,0 +1,52 @@
+#include "prepared_statement.hpp"
+#include "row_cursor.hpp"
+
+namespace sqlite {
+RowIterator::RowIterator() : m_statement{nullptr}
+{
+}
+
+RowIterator::RowIterator(PreparedStatement* statement)
+    : m_statement{statement}
+{
+    ++*this;
+}
+
+Row RowIterator::operator*() const
+{
+    return m_statement->row();
+}
+
+RowIterator& RowIterator::operator++()
+{
+    if (!m_statement->step()) {
+        m_statement = nullptr;
+    }
+
+    return *this;
+}
+
+void RowIterator::operator++(int)
+{
+    ++*this;
+}
+
+bool RowIterator::operator==(std::default_sentinel_t) const
+{
+    return m_statement == nullptr;
+}
+
+RowRange::RowRange(PreparedStatement* statement) : m_statement{statement}
+{
+}
+
+RowIterator RowRange::begin() const
+{
+    return RowIterator{m_statement};
+}
+
+std::default_sentinel_t RowRange::end() const
+{
+    return std::default_sentinel;
+}
+} // namespace sqlite
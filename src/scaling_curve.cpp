@@ -0,0 +1,92 @@
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include "scaling_curve.hpp"
+
+namespace sqlite {
+double ScalingPoint::queriesPerSecond() const
+{
+    return milliseconds > 0.0
+               ? static_cast<double>(queryCount) * 1000.0 / milliseconds
+               : 0.0;
+}
+
+double ScalingPoint::rowsPerSecond() const
+{
+    return milliseconds > 0.0
+               ? static_cast<double>(rowCount) * 1000.0 / milliseconds
+               : 0.0;
+}
+
+std::optional<std::size_t> ScalingCurve::kneeIndex() const
+{
+    if (points.empty()) {
+        return std::nullopt;
+    }
+
+    const double bestQueriesPerSecond{
+        std::max_element(
+            points.begin(),
+            points.end(),
+            [](const ScalingPoint& lhs, const ScalingPoint& rhs) {
+                return lhs.queriesPerSecond() < rhs.queriesPerSecond();
+            })
+            ->queriesPerSecond()};
+
+    for (std::size_t i{0}; i < points.size(); ++i) {
+        if (points[i].queriesPerSecond()
+            >= kneeFraction * bestQueriesPerSecond) {
+            return i;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::vector<std::size_t> sweepThreadCounts(std::size_t maximum)
+{
+    std::vector<std::size_t> threadCounts{};
+
+    for (std::size_t threadCount{1}; threadCount < maximum;
+         threadCount *= 2) {
+        threadCounts.push_back(threadCount);
+    }
+
+    threadCounts.push_back(std::max(maximum, std::size_t{1}));
+    return threadCounts;
+}
+
+void writeScalingCsv(std::ostream& os, const std::vector<ScalingCurve>& curves)
+{
+    os << "threading_mode,connections,threads,queries,rows,milliseconds,"
+          "queries_per_second,rows_per_second,speedup,knee\n";
+
+    for (const ScalingCurve& curve : curves) {
+        if (curve.points.empty()) {
+            continue;
+        }
+
+        const std::optional<std::size_t> knee{curve.kneeIndex()};
+
+        // Speedups are relative to the first, single threaded point.
+        const double baseline{curve.points.front().queriesPerSecond()};
+
+        for (std::size_t i{0}; i < curve.points.size(); ++i) {
+            const ScalingPoint& point{curve.points[i]};
+            os << fmt::format(
+                "{},\"{}\",{},{},{},{:.3f},{:.1f},{:.1f},{:.2f},{}\n",
+                curve.threadingMode,
+                curve.connections,
+                point.threadCount,
+                point.queryCount,
+                point.rowCount,
+                point.milliseconds,
+                point.queriesPerSecond(),
+                point.rowsPerSecond(),
+                baseline > 0.0 ? point.queriesPerSecond() / baseline : 0.0,
+                knee == i);
+        }
+    }
+}
+} // namespace sqlite
@@ -0,0 +1,63 @@
+#include <unordered_map>
+
+#include <fmt/format.h>
+
+#include "scan_status.hpp"
+
+namespace sqlite {
+std::optional<double> PlanElementStatus::actualRowsPerLoop() const
+{
+    if (!loopCount.has_value() || !visitedRowCount.has_value()
+        || *loopCount <= 0) {
+        return std::nullopt;
+    }
+
+    return static_cast<double>(*visitedRowCount)
+           / static_cast<double>(*loopCount);
+}
+
+std::string formatScanStatus(const std::vector<PlanElementStatus>& elements)
+{
+    std::unordered_map<int, int> depths{};
+    std::string                  result{};
+
+    for (const PlanElementStatus& element : elements) {
+        const auto parent{depths.find(element.parentId)};
+        const int  depth{parent != depths.end() ? parent->second + 1 : 0};
+        depths[element.selectId] = depth;
+        result += fmt::format(
+            "{:{}}{}",
+            "",
+            static_cast<std::size_t>(depth) * 2,
+            element.explain);
+
+        if (element.loopCount.has_value()) {
+            result += fmt::format(
+                " (loops {}, rows visited {}",
+                *element.loopCount,
+                element.visitedRowCount.value_or(0));
+
+            if (element.estimatedRowsPerLoop.has_value()) {
+                result += fmt::format(
+                    ", rows per loop estimated {:.1f}",
+                    *element.estimatedRowsPerLoop);
+            }
+
+            if (const std::optional<double> actual{
+                    element.actualRowsPerLoop()}) {
+                result += fmt::format(", actual {:.1f}", *actual);
+            }
+
+            result += ')';
+        }
+
+        if (element.cycleCount.has_value()) {
+            result += fmt::format(" [{} cycles]", *element.cycleCount);
+        }
+
+        result += '\n';
+    }
+
+    return result;
+}
+} // namespace sqlite
@@ -0,0 +1,124 @@
+#include <iterator>
+#include <utility>
+
+#include "database_connection.hpp"
+#include "statement_cache.hpp"
+
+namespace sqlite {
+StatementCache::Handle::Handle(StatementCache* cache, std::list<Entry> entry)
+    : m_cache{cache}, m_entry{std::move(entry)}
+{
+}
+
+StatementCache::Handle::Handle(Handle&& other) noexcept
+    : m_cache{other.m_cache}, m_entry{std::move(other.m_entry)}
+{
+    other.m_cache = nullptr;
+}
+
+StatementCache::Handle& StatementCache::Handle::operator=(
+    Handle&& other) noexcept
+{
+    std::swap(m_cache, other.m_cache);
+    std::swap(m_entry, other.m_entry);
+    return *this;
+}
+
+StatementCache::Handle::~Handle()
+{
+    if (m_cache == nullptr || m_entry.empty()) {
+        return;
+    }
+
+    m_cache->release(m_entry);
+}
+
+PreparedStatement& StatementCache::Handle::operator*() const
+{
+    return *m_entry.front().statement;
+}
+
+PreparedStatement* StatementCache::Handle::operator->() const
+{
+    return m_entry.front().statement.get();
+}
+
+StatementCache::StatementCache(std::size_t capacity)
+    : m_mutex{}
+    , m_capacity{capacity}
+    , m_entries{}
+    , m_index{}
+    , m_hits{0}
+    , m_misses{0}
+    , m_evictions{0}
+{
+}
+
+StatementCache::Handle StatementCache::acquire(
+    DatabaseConnection& connection,
+    const char*         sqlStatement)
+{
+    std::list<Entry> entry{};
+
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        const auto it{m_index.find(std::string_view{sqlStatement})};
+
+        if (it != m_index.end()) {
+            ++m_hits;
+            entry.splice(entry.begin(), m_entries, it->second);
+            m_index.erase(it);
+            return Handle{this, std::move(entry)};
+        }
+
+        ++m_misses;
+    }
+
+    entry.push_back(Entry{
+        sqlStatement,
+        std::make_unique<PreparedStatement>(
+            connection.prepareStatement(sqlStatement))});
+    return Handle{this, std::move(entry)};
+}
+
+StatementCache::Statistics StatementCache::statistics() const
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    return Statistics{
+        m_hits, m_misses, m_evictions, m_entries.size(), m_capacity};
+}
+
+void StatementCache::release(std::list<Entry>& entry)
+{
+    PreparedStatement& statement{*entry.front().statement};
+    statement.reset();
+    statement.clearBindings();
+
+    // Evicted statements are finalized after the lock has been released.
+    std::list<Entry> evicted{};
+
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        m_entries.splice(m_entries.begin(), entry);
+        m_index.emplace(
+            std::string_view{m_entries.front().sql}, m_entries.begin());
+
+        if (m_entries.size() > m_capacity) {
+            const std::list<Entry>::iterator leastRecentlyUsed{
+                std::prev(m_entries.end())};
+            auto [first, last]{m_index.equal_range(
+                std::string_view{leastRecentlyUsed->sql})};
+
+            for (; first != last; ++first) {
+                if (first->second == leastRecentlyUsed) {
+                    m_index.erase(first);
+                    break;
+                }
+            }
+
+            evicted.splice(evicted.begin(), m_entries, leastRecentlyUsed);
+            ++m_evictions;
+        }
+    }
+}
+} // namespace sqlite
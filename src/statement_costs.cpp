@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+#include "statement_costs.hpp"
+
+namespace sqlite {
+namespace {
+struct SqlHash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view sql) const noexcept
+    {
+        return std::hash<std::string_view>{}(sql);
+    }
+};
+
+// Statements add their costs once per run at most, so a mutex is cheap
+// enough here.
+struct CostRegistry {
+    std::atomic<bool> enabled{false};
+    std::mutex        mutex;
+    std::unordered_map<std::string, StatementCosts, SqlHash, std::equal_to<>>
+        costs;
+};
+
+CostRegistry& costRegistry()
+{
+    static CostRegistry registry{};
+    return registry;
+}
+} // anonymous namespace
+
+StatementCosts& StatementCosts::operator+=(const StatementCosts& other)
+{
+    vmSteps += other.vmSteps;
+    fullScanSteps += other.fullScanSteps;
+    sortCount += other.sortCount;
+    autoIndexCount += other.autoIndexCount;
+    reprepareCount += other.reprepareCount;
+    runCount += other.runCount;
+    memoryBytes = std::max(memoryBytes, other.memoryBytes);
+    return *this;
+}
+
+void enableCostAccounting(bool enabled)
+{
+    costRegistry().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool costAccountingEnabled()
+{
+    return costRegistry().enabled.load(std::memory_order_relaxed);
+}
+
+void accumulateCosts(std::string_view sql, const StatementCosts& costs)
+{
+    CostRegistry&                     registry{costRegistry()};
+    const std::lock_guard<std::mutex> lock{registry.mutex};
+    const auto                        it{registry.costs.find(sql)};
+
+    if (it != registry.costs.end()) {
+        it->second += costs;
+    }
+    else {
+        registry.costs.emplace(std::string{sql}, costs);
+    }
+}
+
+std::vector<SqlCosts> accumulatedCosts()
+{
+    std::vector<SqlCosts> result{};
+
+    {
+        CostRegistry&                     registry{costRegistry()};
+        const std::lock_guard<std::mutex> lock{registry.mutex};
+        result.reserve(registry.costs.size());
+
+        for (const auto& [sql, costs] : registry.costs) {
+            result.push_back(SqlCosts{sql, costs});
+        }
+    }
+
+    std::sort(
+        result.begin(),
+        result.end(),
+        [](const SqlCosts& lhs, const SqlCosts& rhs) {
+            return lhs.costs.vmSteps > rhs.costs.vmSteps;
+        });
+    return result;
+}
+
+void resetAccumulatedCosts()
+{
+    CostRegistry&                     registry{costRegistry()};
+    const std::lock_guard<std::mutex> lock{registry.mutex};
+    registry.costs.clear();
+}
+} // namespace sqlite
@@ -0,0 +1,464 @@
+#include <cctype>
+#include <cstdio>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "exception.hpp"
+#include "statement_profiler.hpp"
+#include "throw.hpp"
+
+namespace sqlite {
+namespace {
+struct SqlHash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view sql) const noexcept
+    {
+        return std::hash<std::string_view>{}(sql);
+    }
+};
+
+template <typename Value>
+using SqlMap
+    = std::unordered_map<std::string, Value, SqlHash, std::equal_to<>>;
+
+// The totals of one normalized SQL text in one thread. Only the owning
+// thread writes, so relaxed loads and stores are enough.
+struct ProfileBucket {
+    std::atomic<std::uint64_t> runCount{0};
+    std::atomic<std::uint64_t> rowCount{0};
+    std::atomic<std::uint64_t> totalNanoseconds{0};
+    std::atomic<std::uint64_t> minNanoseconds{
+        std::numeric_limits<std::uint64_t>::max()};
+    std::atomic<std::uint64_t> maxNanoseconds{0};
+
+    void record(std::uint64_t nanoseconds, std::uint64_t rows) noexcept
+    {
+        add(runCount, 1);
+        add(rowCount, rows);
+        add(totalNanoseconds, nanoseconds);
+
+        if (nanoseconds < minNanoseconds.load(std::memory_order_relaxed)) {
+            minNanoseconds.store(nanoseconds, std::memory_order_relaxed);
+        }
+
+        if (nanoseconds > maxNanoseconds.load(std::memory_order_relaxed)) {
+            maxNanoseconds.store(nanoseconds, std::memory_order_relaxed);
+        }
+    }
+
+    void reset() noexcept
+    {
+        runCount.store(0, std::memory_order_relaxed);
+        rowCount.store(0, std::memory_order_relaxed);
+        totalNanoseconds.store(0, std::memory_order_relaxed);
+        minNanoseconds.store(
+            std::numeric_limits<std::uint64_t>::max(),
+            std::memory_order_relaxed);
+        maxNanoseconds.store(0, std::memory_order_relaxed);
+    }
+
+    static void add(
+        std::atomic<std::uint64_t>& counter,
+        std::uint64_t               value) noexcept
+    {
+        counter.store(
+            counter.load(std::memory_order_relaxed) + value,
+            std::memory_order_relaxed);
+    }
+};
+
+void mergeProfile(
+    SqlMap<StatementProfile>& target,
+    const std::string&        sql,
+    const StatementProfile&   profile)
+{
+    if (profile.runCount == 0) {
+        return;
+    }
+
+    const auto [it, inserted]{target.try_emplace(sql, profile)};
+
+    if (inserted) {
+        return;
+    }
+
+    StatementProfile& merged{it->second};
+    merged.runCount += profile.runCount;
+    merged.rowCount += profile.rowCount;
+    merged.totalTime += profile.totalTime;
+    merged.minTime = std::min(merged.minTime, profile.minTime);
+    merged.maxTime = std::max(merged.maxTime, profile.maxTime);
+}
+
+StatementProfile toProfile(const std::string& sql, const ProfileBucket& bucket)
+{
+    const auto nanoseconds{[](const std::atomic<std::uint64_t>& counter) {
+        return std::chrono::nanoseconds{static_cast<std::int64_t>(
+            counter.load(std::memory_order_relaxed))};
+    }};
+    return StatementProfile{
+        sql,
+        bucket.runCount.load(std::memory_order_relaxed),
+        bucket.rowCount.load(std::memory_order_relaxed),
+        nanoseconds(bucket.totalNanoseconds),
+        nanoseconds(bucket.minNanoseconds),
+        nanoseconds(bucket.maxNanoseconds)};
+}
+
+class ThreadProfiles;
+
+// Knows the buckets of every live thread and keeps the profiles of threads
+// that have exited. Locked before the mutex of a ThreadProfiles.
+struct ProfileRegistry {
+    std::mutex                   mutex;
+    std::vector<ThreadProfiles*> threads;
+    SqlMap<StatementProfile>     retired;
+};
+
+ProfileRegistry& profileRegistry()
+{
+    static ProfileRegistry registry{};
+    return registry;
+}
+
+// The buckets and the statements in progress of one thread. Only the
+// owning thread records; m_mutex keeps other threads from reading
+// m_buckets while a new SQL text is inserted.
+class ThreadProfiles {
+public:
+    ThreadProfiles() : m_mutex{}, m_buckets{}, m_bucketsBySql{}, m_runs{}
+    {
+        ProfileRegistry&                  registry{profileRegistry()};
+        const std::lock_guard<std::mutex> lock{registry.mutex};
+        registry.threads.push_back(this);
+    }
+
+    ThreadProfiles(const ThreadProfiles&) = delete;
+
+    ThreadProfiles& operator=(const ThreadProfiles&) = delete;
+
+    ~ThreadProfiles()
+    {
+        ProfileRegistry&                  registry{profileRegistry()};
+        const std::lock_guard<std::mutex> lock{registry.mutex};
+        mergeInto(registry.retired);
+        std::erase(registry.threads, this);
+    }
+
+    void startRun(sqlite3_stmt* statement)
+    {
+        const Run run{statement, std::chrono::steady_clock::now(), 0};
+
+        if (Run* const existing{findRun(statement)}) {
+            *existing = run;
+        }
+        else {
+            m_runs.push_back(run);
+        }
+    }
+
+    void countRow(sqlite3_stmt* statement) noexcept
+    {
+        if (Run* const run{findRun(statement)}) {
+            ++run->rowCount;
+        }
+    }
+
+    // SQLite's own estimate of the run time has millisecond resolution, so
+    // it is only used for runs that started before profiling was enabled.
+    void finishRun(
+        sqlite3_stmt* statement,
+        std::int64_t  estimatedNanoseconds)
+    {
+        std::uint64_t nanoseconds{
+            static_cast<std::uint64_t>(std::max<std::int64_t>(
+                estimatedNanoseconds, 0))};
+        std::uint64_t rowCount{0};
+
+        if (Run* const run{findRun(statement)}) {
+            nanoseconds = static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - run->start)
+                    .count());
+            rowCount = run->rowCount;
+            *run     = m_runs.back();
+            m_runs.pop_back();
+        }
+
+        const char* const sql{sqlite3_sql(statement)};
+        bucket(sql != nullptr ? sql : "").record(nanoseconds, rowCount);
+    }
+
+    void mergeInto(SqlMap<StatementProfile>& target) const
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+
+        for (const auto& [sql, bucket] : m_buckets) {
+            mergeProfile(target, sql, toProfile(sql, *bucket));
+        }
+    }
+
+    void reset()
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+
+        for (const auto& [sql, bucket] : m_buckets) {
+            bucket->reset();
+        }
+    }
+
+private:
+    struct Run {
+        sqlite3_stmt*                         statement;
+        std::chrono::steady_clock::time_point start;
+        std::uint64_t                         rowCount;
+    };
+
+    // A thread rarely has more than a couple of statements in progress.
+    Run* findRun(sqlite3_stmt* statement) noexcept
+    {
+        for (Run& run : m_runs) {
+            if (run.statement == statement) {
+                return &run;
+            }
+        }
+
+        return nullptr;
+    }
+
+    // Normalizes every SQL text only the first time this thread runs it.
+    ProfileBucket& bucket(std::string_view sql)
+    {
+        const auto it{m_bucketsBySql.find(sql)};
+
+        if (it != m_bucketsBySql.end()) {
+            return *it->second;
+        }
+
+        std::string                       normalized{normalizeSql(sql)};
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        std::unique_ptr<ProfileBucket>&   bucket{m_buckets[normalized]};
+
+        if (bucket == nullptr) {
+            bucket = std::make_unique<ProfileBucket>();
+        }
+
+        m_bucketsBySql.emplace(std::string{sql}, bucket.get());
+        return *bucket;
+    }
+
+    mutable std::mutex                     m_mutex;
+    SqlMap<std::unique_ptr<ProfileBucket>> m_buckets;
+    // Only used by the owning thread, like m_runs.
+    SqlMap<ProfileBucket*> m_bucketsBySql;
+    std::vector<Run>       m_runs;
+};
+
+ThreadProfiles& threadProfiles()
+{
+    thread_local ThreadProfiles profiles{};
+    return profiles;
+}
+
+int traceStatement(
+    unsigned type,
+    void*    /* context */,
+    void*    statement,
+    void*    detail)
+{
+    sqlite3_stmt* const stmt{static_cast<sqlite3_stmt*>(statement)};
+
+    // SQLite can't propagate exceptions through its callbacks.
+    try {
+        switch (type) {
+        case SQLITE_TRACE_STMT:
+            // Trigger programs are reported as comments starting with "--"
+            // while the statement that fired them is running.
+            if (!std::string_view{static_cast<const char*>(detail)}
+                     .starts_with("--")) {
+                threadProfiles().startRun(stmt);
+            }
+
+            break;
+        case SQLITE_TRACE_ROW:
+            threadProfiles().countRow(stmt);
+            break;
+        case SQLITE_TRACE_PROFILE:
+            threadProfiles().finishRun(
+                stmt, *static_cast<const sqlite3_int64*>(detail));
+            break;
+        }
+    }
+    catch (const std::exception& ex) {
+        std::fprintf(stderr, "Statement profiler failed: %s\n", ex.what());
+    }
+
+    return 0;
+}
+
+bool isIdentifierCharacter(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_'
+           || c == '$';
+}
+
+// Returns the index past the quote that closes the one at sql[open];
+// doubled quotes don't close it.
+std::size_t skipQuoted(std::string_view sql, std::size_t open, char close)
+{
+    std::size_t i{open + 1};
+
+    while (i < sql.size()) {
+        if (sql[i] != close) {
+            ++i;
+        }
+        else if (close != ']' && i + 1 < sql.size() && sql[i + 1] == close) {
+            i += 2;
+        }
+        else {
+            return i + 1;
+        }
+    }
+
+    return sql.size();
+}
+} // anonymous namespace
+
+void enableStatementProfiling(sqlite3* connection)
+{
+    const int resultCode{sqlite3_trace_v2(
+        /* db */ connection,
+        /* uMask */ SQLITE_TRACE_STMT | SQLITE_TRACE_ROW
+            | SQLITE_TRACE_PROFILE,
+        /* xCallback */ &traceStatement,
+        /* pCtx */ nullptr)};
+
+    if (resultCode != SQLITE_OK) {
+        SQLITE_THROW(
+            Exception,
+            resultCode,
+            "Couldn't enable statement profiling: \"{}\"",
+            sqlite3_errmsg(connection));
+    }
+}
+
+std::vector<StatementProfile> statementProfiles()
+{
+    SqlMap<StatementProfile> merged{};
+
+    {
+        ProfileRegistry&                  registry{profileRegistry()};
+        const std::lock_guard<std::mutex> lock{registry.mutex};
+
+        for (const auto& [sql, profile] : registry.retired) {
+            mergeProfile(merged, sql, profile);
+        }
+
+        for (const ThreadProfiles* profiles : registry.threads) {
+            profiles->mergeInto(merged);
+        }
+    }
+
+    std::vector<StatementProfile> profiles{};
+    profiles.reserve(merged.size());
+
+    for (auto& [sql, profile] : merged) {
+        profiles.push_back(std::move(profile));
+    }
+
+    std::sort(
+        profiles.begin(),
+        profiles.end(),
+        [](const StatementProfile& lhs, const StatementProfile& rhs) {
+            return lhs.totalTime > rhs.totalTime;
+        });
+    return profiles;
+}
+
+void resetStatementProfiles()
+{
+    ProfileRegistry&                  registry{profileRegistry()};
+    const std::lock_guard<std::mutex> lock{registry.mutex};
+    registry.retired.clear();
+
+    for (ThreadProfiles* profiles : registry.threads) {
+        profiles->reset();
+    }
+}
+
+std::string normalizeSql(std::string_view sql)
+{
+    std::string normalized{};
+    normalized.reserve(sql.size());
+    std::size_t i{0};
+
+    while (i < sql.size()) {
+        const char c{sql[i]};
+
+        if (std::isspace(static_cast<unsigned char>(c)) != 0) {
+            while (i < sql.size()
+                   && std::isspace(static_cast<unsigned char>(sql[i])) != 0) {
+                ++i;
+            }
+
+            if (!normalized.empty() && i < sql.size()) {
+                normalized += ' ';
+            }
+
+            continue;
+        }
+
+        const bool afterIdentifier{
+            !normalized.empty() && isIdentifierCharacter(normalized.back())};
+
+        if (c == '\'') {
+            i = skipQuoted(sql, i, '\'');
+            normalized += '?';
+        }
+        else if (
+            (c == 'x' || c == 'X') && !afterIdentifier && i + 1 < sql.size()
+            && sql[i + 1] == '\'') {
+            i = skipQuoted(sql, i + 1, '\'');
+            normalized += '?';
+        }
+        else if (c == '"' || c == '`' || c == '[') {
+            const std::size_t end{skipQuoted(sql, i, c == '[' ? ']' : c)};
+            normalized.append(sql.substr(i, end - i));
+            i = end;
+        }
+        else if (
+            !afterIdentifier
+            && (std::isdigit(static_cast<unsigned char>(c)) != 0
+                || (c == '.' && i + 1 < sql.size()
+                    && std::isdigit(static_cast<unsigned char>(sql[i + 1]))
+                           != 0))) {
+            // Covers decimals, exponents and hexadecimal literals.
+            ++i;
+
+            while (i < sql.size()
+                   && (isIdentifierCharacter(sql[i]) || sql[i] == '.'
+                       || ((sql[i] == '+' || sql[i] == '-')
+                           && (sql[i - 1] == 'e' || sql[i - 1] == 'E')))) {
+                ++i;
+            }
+
+            normalized += '?';
+        }
+        else {
+            normalized += c;
+            ++i;
+        }
+    }
+
+    return normalized;
+}
+} // namespace sqlite
@@ -0,0 +1,70 @@
+#include <sqlite3.h>
+
+#include "exception.hpp"
+#include "threading_mode.hpp"
+#include "throw.hpp"
+
+namespace sqlite {
+static int configOption(ThreadingMode mode)
+{
+    switch (mode) {
+    case ThreadingMode::SingleThread:
+        return SQLITE_CONFIG_SINGLETHREAD;
+    case ThreadingMode::MultiThread:
+        return SQLITE_CONFIG_MULTITHREAD;
+    case ThreadingMode::Serialized:
+        return SQLITE_CONFIG_SERIALIZED;
+    }
+
+    return SQLITE_CONFIG_SERIALIZED;
+}
+
+const char* threadingModeName(ThreadingMode mode)
+{
+    switch (mode) {
+    case ThreadingMode::SingleThread:
+        return "SINGLETHREAD";
+    case ThreadingMode::MultiThread:
+        return "MULTITHREAD";
+    case ThreadingMode::Serialized:
+        return "SERIALIZED";
+    }
+
+    return "unknown";
+}
+
+void configureThreadingMode(ThreadingMode mode)
+{
+    int resultCode{sqlite3_shutdown()};
+
+    if (resultCode != SQLITE_OK) {
+        SQLITE_THROW(
+            Exception,
+            resultCode,
+            "sqlite3_shutdown failed, mode: {}",
+            threadingModeName(mode));
+    }
+
+    // Fails if SQLite was compiled without support for mode, e.g. with
+    // SQLITE_THREADSAFE=0.
+    resultCode = sqlite3_config(configOption(mode));
+
+    if (resultCode != SQLITE_OK) {
+        SQLITE_THROW(
+            Exception,
+            resultCode,
+            "sqlite3_config failed, mode: {}",
+            threadingModeName(mode));
+    }
+
+    resultCode = sqlite3_initialize();
+
+    if (resultCode != SQLITE_OK) {
+        SQLITE_THROW(
+            Exception,
+            resultCode,
+            "sqlite3_initialize failed, mode: {}",
+            threadingModeName(mode));
+    }
+}
+} // namespace sqlite
@@ -0,0 +1,117 @@
+#include <cstdio>
+
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "as_string.hpp"
+#include "database_connection.hpp"
+#include "throw.hpp"
+#include "transaction.hpp"
+
+namespace sqlite {
+static const char* beginStatement(Transaction::Mode mode)
+{
+    switch (mode) {
+    case Transaction::Mode::Deferred:
+        return "BEGIN DEFERRED;";
+    case Transaction::Mode::Immediate:
+        return "BEGIN IMMEDIATE;";
+    case Transaction::Mode::Exclusive:
+        return "BEGIN EXCLUSIVE;";
+    }
+
+    return "BEGIN;";
+}
+
+Transaction::Transaction(DatabaseConnection& connection, Mode mode)
+    : m_connection{nullptr}, m_savepoint{}
+{
+    if (connection.m_transactionDepth == 0) {
+        connection.execute(beginStatement(mode));
+    }
+    else {
+        m_savepoint
+            = fmt::format("savepoint_{}", connection.m_transactionDepth);
+        connection.execute(fmt::format("SAVEPOINT {};", m_savepoint).c_str());
+    }
+
+    ++connection.m_transactionDepth;
+    m_connection = &connection;
+}
+
+Transaction::Transaction(Transaction&& other) noexcept
+    : m_connection{other.m_connection}
+    , m_savepoint{std::move(other.m_savepoint)}
+{
+    other.m_connection = nullptr;
+}
+
+Transaction& Transaction::operator=(Transaction&& other) noexcept
+{
+    std::swap(m_connection, other.m_connection);
+    std::swap(m_savepoint, other.m_savepoint);
+    return *this;
+}
+
+Transaction::~Transaction()
+{
+    if (m_connection == nullptr) {
+        return;
+    }
+
+    try {
+        rollback();
+    }
+    catch (const Exception& ex) {
+        std::fprintf(
+            stderr,
+            "Failed to roll back transaction. resultCode: %s, error message: "
+            "\"%s\"\n",
+            asString(ex.resultCode()),
+            ex.message().c_str());
+        --m_connection->m_transactionDepth;
+    }
+}
+
+void Transaction::commit()
+{
+    finish("COMMIT;", /* rollBackSavepoint */ false);
+}
+
+void Transaction::rollback()
+{
+    finish("ROLLBACK;", /* rollBackSavepoint */ true);
+}
+
+bool Transaction::isSavepoint() const
+{
+    return !m_savepoint.empty();
+}
+
+void Transaction::finish(const char* topLevelStatement, bool rollBackSavepoint)
+{
+    if (m_connection == nullptr) {
+        SQLITE_THROW(
+            Exception,
+            SQLITE_MISUSE,
+            "Transaction has already been finished: \"{}\"",
+            topLevelStatement);
+    }
+
+    if (m_savepoint.empty()) {
+        m_connection->execute(topLevelStatement);
+    }
+    else {
+        if (rollBackSavepoint) {
+            m_connection->execute(
+                fmt::format("ROLLBACK TO {};", m_savepoint).c_str());
+        }
+
+        m_connection->execute(fmt::format("RELEASE {};", m_savepoint).c_str());
+    }
+
+    --m_connection->m_transactionDepth;
+    m_connection = nullptr;
+}
+} // namespace sqlite